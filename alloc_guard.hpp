@@ -0,0 +1,219 @@
+// KT header-only library
+// Requirements: C++17
+// Define KT_ALLOC_GUARD_IMPLEMENTATION in exactly one translation unit (of a test / checking binary) to install
+// counting replacements of the global operator new family; define KT_ALLOC_GUARD_HOOK_MALLOC as well to also count
+// malloc / calloc / realloc (glibc only; not with sanitizers, which replace malloc themselves)
+
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+namespace kt {
+///
+/// \brief Allocations made by the calling thread since it started (zero unless the hooks are installed)
+///
+struct alloc_stats {
+	std::size_t count{};
+	std::size_t bytes{};
+};
+
+alloc_stats thread_alloc_stats() noexcept;
+///
+/// \brief Probe whether allocations are being counted (ie KT_ALLOC_GUARD_IMPLEMENTATION is linked in)
+///
+bool alloc_hooks_active() noexcept;
+
+///
+/// \brief Measures allocations made by this thread while the scope is alive
+///
+class alloc_scope {
+  public:
+	alloc_scope() noexcept : m_start(thread_alloc_stats()) {}
+
+	alloc_stats delta() const noexcept;
+
+  private:
+	alloc_stats m_start;
+};
+
+///
+/// \brief Called when a no_alloc_scope ends with allocations (count / bytes made inside it)
+///
+using alloc_violation_handler = void (*)(alloc_stats allocated) noexcept;
+
+///
+/// \brief Replace the violation handler (nullptr restores the default: report to stderr and std::abort); returns the previous one
+///
+alloc_violation_handler set_alloc_violation_handler(alloc_violation_handler handler) noexcept;
+
+///
+/// \brief Reports (via the violation handler) if this thread made any allocations while the scope was alive
+/// The check does not depend on NDEBUG
+///
+class no_alloc_scope : public alloc_scope {
+  public:
+	~no_alloc_scope();
+};
+
+///
+/// \brief Allocations made by this thread while running f()
+///
+template <typename F>
+alloc_stats count_allocations(F&& f) {
+	alloc_scope const scope;
+	f();
+	return scope.delta();
+}
+
+namespace detail {
+inline alloc_stats& thread_alloc_counter() noexcept {
+	thread_local alloc_stats ret;
+	return ret;
+}
+
+inline void count_alloc(std::size_t size) noexcept {
+	auto& stats = thread_alloc_counter();
+	++stats.count;
+	stats.bytes += size;
+}
+} // namespace detail
+
+namespace detail {
+inline void default_alloc_violation(alloc_stats allocated) noexcept {
+	std::fprintf(stderr, "kt::no_alloc_scope: %zu allocation(s), %zu byte(s)\n", allocated.count, allocated.bytes);
+	std::abort();
+}
+
+inline std::atomic<alloc_violation_handler>& alloc_violation_slot() noexcept {
+	static std::atomic<alloc_violation_handler> ret{&default_alloc_violation};
+	return ret;
+}
+} // namespace detail
+
+inline alloc_stats thread_alloc_stats() noexcept { return detail::thread_alloc_counter(); }
+
+inline alloc_violation_handler set_alloc_violation_handler(alloc_violation_handler handler) noexcept {
+	return detail::alloc_violation_slot().exchange(handler ? handler : &detail::default_alloc_violation);
+}
+
+inline no_alloc_scope::~no_alloc_scope() {
+	auto const allocated = delta();
+	if (allocated.count != 0) { detail::alloc_violation_slot().load()(allocated); }
+}
+
+inline alloc_stats alloc_scope::delta() const noexcept {
+	auto const now = thread_alloc_stats();
+	return {now.count - m_start.count, now.bytes - m_start.bytes};
+}
+
+inline bool alloc_hooks_active() noexcept {
+	auto const before = thread_alloc_stats().count;
+	// volatile pointer keeps the new/delete pair from being elided
+	void* volatile probe = ::operator new(1);
+	::operator delete(probe);
+	return thread_alloc_stats().count != before;
+}
+} // namespace kt
+
+#if defined(KT_ALLOC_GUARD_IMPLEMENTATION)
+#if defined(KT_ALLOC_GUARD_HOOK_MALLOC) && defined(__GLIBC__)
+extern "C" {
+void* __libc_malloc(std::size_t);
+void* __libc_calloc(std::size_t, std::size_t);
+void* __libc_realloc(void*, std::size_t);
+void __libc_free(void*);
+
+void* malloc(std::size_t size) {
+	kt::detail::count_alloc(size);
+	return __libc_malloc(size);
+}
+void* calloc(std::size_t count, std::size_t size) {
+	kt::detail::count_alloc(count * size);
+	return __libc_calloc(count, size);
+}
+void* realloc(void* ptr, std::size_t size) {
+	kt::detail::count_alloc(size);
+	return __libc_realloc(ptr, size);
+}
+void free(void* ptr) { __libc_free(ptr); }
+}
+
+namespace kt::detail {
+inline void* alloc_guard_raw(std::size_t size) noexcept { return __libc_malloc(size); }
+inline void alloc_guard_free(void* ptr) noexcept { __libc_free(ptr); }
+} // namespace kt::detail
+#else
+namespace kt::detail {
+inline void* alloc_guard_raw(std::size_t size) noexcept { return std::malloc(size); }
+inline void alloc_guard_free(void* ptr) noexcept { std::free(ptr); }
+} // namespace kt::detail
+#endif
+
+namespace kt::detail {
+inline void* alloc_guard_new(std::size_t size) {
+	count_alloc(size);
+	if (size == 0) { size = 1; }
+	void* ret = alloc_guard_raw(size);
+	if (!ret) { throw std::bad_alloc(); }
+	return ret;
+}
+
+inline void* alloc_guard_new(std::size_t size, std::align_val_t align) {
+	count_alloc(size);
+	auto const al = static_cast<std::size_t>(align);
+	size = size == 0 ? al : (size + al - 1) / al * al;
+#if defined(_MSC_VER)
+	void* ret = _aligned_malloc(size, al);
+#else
+	void* ret = std::aligned_alloc(al, size);
+#endif
+	if (!ret) { throw std::bad_alloc(); }
+	return ret;
+}
+
+inline void alloc_guard_delete_aligned(void* ptr) noexcept {
+#if defined(_MSC_VER)
+	_aligned_free(ptr);
+#else
+	std::free(ptr);
+#endif
+}
+} // namespace kt::detail
+
+void* operator new(std::size_t size) { return kt::detail::alloc_guard_new(size); }
+void* operator new[](std::size_t size) { return kt::detail::alloc_guard_new(size); }
+void* operator new(std::size_t size, std::nothrow_t const&) noexcept {
+	try {
+		return kt::detail::alloc_guard_new(size);
+	} catch (...) { return nullptr; }
+}
+void* operator new[](std::size_t size, std::nothrow_t const&) noexcept {
+	try {
+		return kt::detail::alloc_guard_new(size);
+	} catch (...) { return nullptr; }
+}
+void* operator new(std::size_t size, std::align_val_t align) { return kt::detail::alloc_guard_new(size, align); }
+void* operator new[](std::size_t size, std::align_val_t align) { return kt::detail::alloc_guard_new(size, align); }
+void* operator new(std::size_t size, std::align_val_t align, std::nothrow_t const&) noexcept {
+	try {
+		return kt::detail::alloc_guard_new(size, align);
+	} catch (...) { return nullptr; }
+}
+void* operator new[](std::size_t size, std::align_val_t align, std::nothrow_t const&) noexcept {
+	try {
+		return kt::detail::alloc_guard_new(size, align);
+	} catch (...) { return nullptr; }
+}
+
+void operator delete(void* ptr) noexcept { kt::detail::alloc_guard_free(ptr); }
+void operator delete[](void* ptr) noexcept { kt::detail::alloc_guard_free(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { kt::detail::alloc_guard_free(ptr); }
+void operator delete[](void* ptr, std::size_t) noexcept { kt::detail::alloc_guard_free(ptr); }
+void operator delete(void* ptr, std::align_val_t) noexcept { kt::detail::alloc_guard_delete_aligned(ptr); }
+void operator delete[](void* ptr, std::align_val_t) noexcept { kt::detail::alloc_guard_delete_aligned(ptr); }
+void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept { kt::detail::alloc_guard_delete_aligned(ptr); }
+void operator delete[](void* ptr, std::size_t, std::align_val_t) noexcept { kt::detail::alloc_guard_delete_aligned(ptr); }
+#endif
@@ -0,0 +1,330 @@
+// KT header-only library
+// Requirements: C++17
+// Error-path scaling on 1..N threads: kt::result propagation versus throwing exceptions
+// Throwing contends on the unwinder (dl_iterate_phdr / frame registration locks) and allocates the exception object;
+// the *_string variants add an allocated error payload to both sides
+// Cold mode (--cold) instead times single calls on one thread, success and error path separately, each one after
+// evicting the data caches (streaming over a large buffer) and polluting the instruction cache and branch predictors
+// (calling through a large table of distinct dummy functions), next to the same calls in a warm loop
+// Build and run (from the repository root):
+// 	g++ -std=c++17 -O2 -pthread -I. bench/error_scaling.cpp -o error_scaling && ./error_scaling [max_threads] [error_percent] [calls_per_thread]
+// 	./error_scaling --cold [samples] [evict_MiB]
+
+#include "result.hpp"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#if defined(__GNUC__) || defined(__clang__)
+#define KT_BENCH_NOINLINE __attribute__((noinline))
+#elif defined(_MSC_VER)
+#define KT_BENCH_NOINLINE __declspec(noinline)
+#else
+#define KT_BENCH_NOINLINE
+#endif
+
+namespace {
+enum class error { unknown, rejected };
+
+///
+/// \brief Frames between the failing call and the handler
+///
+constexpr int depth = 8;
+
+///
+/// \brief Error message long enough to defeat the small string optimization
+///
+char const* const message = "record rejected: field 3 is out of range for its column";
+
+///
+/// \brief xorshift per thread; fails percent of calls
+///
+struct input {
+	std::uint32_t state;
+	std::uint32_t threshold;
+
+	bool next_fails() noexcept {
+		state ^= state << 13;
+		state ^= state >> 17;
+		state ^= state << 5;
+		return state % 100 < threshold;
+	}
+};
+
+template <int D>
+KT_BENCH_NOINLINE kt::result<int, error> result_enum(input& in) {
+	if constexpr (D == 0) {
+		if (in.next_fails()) { return error::rejected; }
+		return int(in.state & 0xff);
+	} else {
+		auto ret = result_enum<D - 1>(in);
+		if (!ret) { return ret.error(); }
+		return ret.value() + 1;
+	}
+}
+
+template <int D>
+KT_BENCH_NOINLINE kt::result<int, std::string> result_string(input& in) {
+	if constexpr (D == 0) {
+		if (in.next_fails()) { return std::string(message); }
+		return int(in.state & 0xff);
+	} else {
+		auto ret = result_string<D - 1>(in);
+		if (!ret) { return std::move(ret).error(); }
+		return ret.value() + 1;
+	}
+}
+
+template <int D>
+KT_BENCH_NOINLINE int throw_enum(input& in) {
+	if constexpr (D == 0) {
+		if (in.next_fails()) { throw error::rejected; }
+		return int(in.state & 0xff);
+	} else {
+		return throw_enum<D - 1>(in) + 1;
+	}
+}
+
+template <int D>
+KT_BENCH_NOINLINE int throw_string(input& in) {
+	if constexpr (D == 0) {
+		if (in.next_fails()) { throw std::runtime_error(message); }
+		return int(in.state & 0xff);
+	} else {
+		return throw_string<D - 1>(in) + 1;
+	}
+}
+
+///
+/// \brief One call of a workload: returns a value folded into the checksum (errors fold as -1)
+///
+using workload_fn = long (*)(input&);
+
+long run_result_enum(input& in) {
+	auto const ret = result_enum<depth>(in);
+	return ret ? ret.value() : -1;
+}
+
+long run_result_string(input& in) {
+	auto const ret = result_string<depth>(in);
+	return ret ? ret.value() : -long(ret.error().size() != 0);
+}
+
+long run_throw_enum(input& in) {
+	try {
+		return throw_enum<depth>(in);
+	} catch (error) { return -1; }
+}
+
+long run_throw_string(input& in) {
+	try {
+		return throw_string<depth>(in);
+	} catch (std::runtime_error const& e) { return -long(e.what()[0] != 0); }
+}
+
+struct workload {
+	char const* name;
+	workload_fn fn;
+};
+
+constexpr workload workloads[] = {
+	{"result<int, enum>", &run_result_enum},
+	{"result<int, string>", &run_result_string},
+	{"throw enum", &run_throw_enum},
+	{"throw runtime_error", &run_throw_string},
+};
+
+struct run_stats {
+	double seconds{};
+	long checksum{};
+};
+
+///
+/// \brief Run calls of fn on each of threads threads, released together; wall time from release to last join
+///
+run_stats run(workload_fn fn, unsigned threads, unsigned error_percent, std::size_t calls) {
+	std::atomic<unsigned> ready{};
+	std::atomic<bool> go{};
+	std::vector<long> sums(threads);
+	std::vector<std::thread> pool;
+	pool.reserve(threads);
+	for (unsigned t = 0; t < threads; ++t) {
+		pool.emplace_back([&, t] {
+			input in{0x9E3779B9U * (t + 1), error_percent};
+			long sum{};
+			ready.fetch_add(1);
+			while (!go.load(std::memory_order_acquire)) { std::this_thread::yield(); }
+			for (std::size_t i = 0; i < calls; ++i) { sum += fn(in); }
+			sums[t] = sum;
+		});
+	}
+	while (ready.load() != threads) { std::this_thread::yield(); }
+	auto const start = std::chrono::steady_clock::now();
+	go.store(true, std::memory_order_release);
+	for (auto& thread : pool) { thread.join(); }
+	auto const end = std::chrono::steady_clock::now();
+	run_stats ret;
+	ret.seconds = std::chrono::duration<double>(end - start).count();
+	for (long const sum : sums) { ret.checksum += sum; }
+	return ret;
+}
+
+// cold mode
+
+///
+/// \brief Distinct function bodies (~150 bytes each, ~150 KB in all: several times a typical L1 instruction cache;
+/// the streaming pass already evicts the unified caches)
+///
+constexpr std::size_t dummy_count = 1024;
+
+template <std::size_t I>
+KT_BENCH_NOINLINE std::uint64_t dummy(std::uint64_t x) {
+	constexpr std::uint64_t k = 0x9E3779B97F4A7C15ULL * (I + 1);
+	x = (x ^ (x >> 31)) * (k | 1);
+	x = (x ^ (x >> 27)) + (k >> 7);
+	x = (x ^ (x >> 33)) * ((k << 3) | 1);
+	x = (x ^ (x >> 29)) + (k >> 13);
+	x = (x ^ (x >> 31)) * ((k >> 5) | 1);
+	x = (x ^ (x >> 23)) + (k << 11);
+	return x ^ I;
+}
+
+using dummy_fn = std::uint64_t (*)(std::uint64_t);
+
+template <std::size_t... I>
+constexpr std::array<dummy_fn, sizeof...(I)> make_dummies(std::index_sequence<I...>) {
+	return {{&dummy<I>...}};
+}
+
+constexpr std::array<dummy_fn, dummy_count> dummies = make_dummies(std::make_index_sequence<dummy_count>{});
+
+///
+/// \brief Evicts data and instruction caches (and trains indirect branch predictors elsewhere) before a measured call
+///
+class cache_polluter {
+  public:
+	explicit cache_polluter(std::size_t bytes) : m_buffer(bytes / sizeof(std::uint64_t), 1) {}
+
+	void pollute() {
+		// write then read every line so dirty and clean lines alike are displaced
+		for (std::size_t i = 0; i < m_buffer.size(); i += 8) { m_buffer[i] += i; }
+		std::uint64_t acc{};
+		for (std::size_t i = 0; i < m_buffer.size(); i += 8) { acc += m_buffer[i]; }
+		// strided order so consecutive calls do not share lines or predictor entries
+		for (std::size_t i = 0; i < dummy_count; ++i) { acc = dummies[(i * 997) % dummy_count](acc); }
+		m_sink = acc;
+	}
+
+	std::uint64_t sink() const noexcept { return m_sink; }
+
+  private:
+	std::vector<std::uint64_t> m_buffer;
+	std::uint64_t m_sink{};
+};
+
+///
+/// \brief Median and 90th percentile of samples (sorted in place)
+///
+std::pair<double, double> percentiles(std::vector<double>& samples) {
+	std::sort(samples.begin(), samples.end());
+	return {samples[samples.size() / 2], samples[samples.size() * 9 / 10]};
+}
+
+///
+/// \brief ns per call over a batch of calls, minus the timer's own cost (overhead)
+///
+double time_calls(workload_fn fn, input& in, std::size_t calls, long& sum, double overhead) {
+	auto const start = std::chrono::steady_clock::now();
+	for (std::size_t i = 0; i < calls; ++i) { sum += fn(in); }
+	auto const end = std::chrono::steady_clock::now();
+	return std::max(0.0, std::chrono::duration<double, std::nano>(end - start).count() - overhead) / double(calls);
+}
+
+double timer_overhead() {
+	std::vector<double> samples(1000);
+	for (auto& s : samples) {
+		auto const start = std::chrono::steady_clock::now();
+		auto const end = std::chrono::steady_clock::now();
+		s = std::chrono::duration<double, std::nano>(end - start).count();
+	}
+	return percentiles(samples).first;
+}
+
+int run_cold(std::size_t samples, std::size_t evict_mib) {
+	cache_polluter polluter(evict_mib << 20);
+	double const overhead = timer_overhead();
+	std::printf("cold mode: %zu samples per path, %zu MiB evicted and %zu dummy functions called before each cold call, timer overhead %.0f ns\n",
+				samples, evict_mib, dummy_count, overhead);
+	std::printf("%-22s %-7s %12s %12s %12s %12s %9s\n", "workload", "path", "warm p50 ns", "warm p90 ns", "cold p50 ns", "cold p90 ns", "cold/warm");
+	long sum{};
+	for (auto const& w : workloads) {
+		for (unsigned const error_percent : {0U, 100U}) {
+			input in{0x2545F491U, error_percent};
+			std::vector<double> warm(samples);
+			std::vector<double> cold(samples);
+			for (std::size_t i = 0; i < 1000; ++i) { sum += w.fn(in); }
+			// warm calls are too short to time one by one: batches of 100
+			for (auto& s : warm) { s = time_calls(w.fn, in, 100, sum, overhead); }
+			for (auto& s : cold) {
+				polluter.pollute();
+				s = time_calls(w.fn, in, 1, sum, overhead);
+			}
+			auto const [warm50, warm90] = percentiles(warm);
+			auto const [cold50, cold90] = percentiles(cold);
+			std::printf("%-22s %-7s %12.1f %12.1f %12.0f %12.0f %8.1fx\n", w.name, error_percent ? "error" : "success", warm50, warm90, cold50, cold90,
+						cold50 / std::max(warm50, 0.1));
+		}
+	}
+	std::printf("(checksum %ld / %llu)\n", sum, static_cast<unsigned long long>(polluter.sink()));
+	return 0;
+}
+} // namespace
+
+int main(int argc, char** argv) {
+	if (argc > 1 && std::string(argv[1]) == "--cold") {
+		std::size_t const samples = argc > 2 ? std::size_t(std::strtoull(argv[2], nullptr, 10)) : 200;
+		std::size_t const evict_mib = argc > 3 ? std::size_t(std::strtoull(argv[3], nullptr, 10)) : 64;
+		if (samples == 0 || evict_mib == 0) {
+			std::fprintf(stderr, "usage: %s --cold [samples >= 1] [evict_MiB >= 1]\n", argv[0]);
+			return 1;
+		}
+		return run_cold(samples, evict_mib);
+	}
+
+	unsigned const hardware = std::max(1U, std::thread::hardware_concurrency());
+	unsigned const max_threads = argc > 1 ? unsigned(std::strtoul(argv[1], nullptr, 10)) : hardware;
+	unsigned const error_percent = argc > 2 ? unsigned(std::strtoul(argv[2], nullptr, 10)) : 50;
+	std::size_t const calls = argc > 3 ? std::size_t(std::strtoull(argv[3], nullptr, 10)) : 200000;
+	if (max_threads == 0 || error_percent > 100 || calls == 0) {
+		std::fprintf(stderr, "usage: %s [max_threads >= 1] [error_percent 0..100] [calls_per_thread >= 1]\n", argv[0]);
+		return 1;
+	}
+
+	std::vector<unsigned> counts;
+	for (unsigned t = 1; t < max_threads; t *= 2) { counts.push_back(t); }
+	counts.push_back(max_threads);
+
+	std::printf("%u hardware threads, %u%% errors, %zu calls per thread, depth %d\n", hardware, error_percent, calls, depth);
+	std::printf("%-22s %8s %14s %14s %10s\n", "workload", "threads", "Mcalls/s", "ns/call/thread", "scaling");
+	for (auto const& w : workloads) {
+		double base{};
+		for (unsigned const threads : counts) {
+			auto const stats = run(w.fn, threads, error_percent, calls);
+			double const total = double(calls) * threads;
+			double const rate = total / stats.seconds;
+			if (threads == 1) { base = rate; }
+			std::printf("%-22s %8u %14.2f %14.1f %9.2fx   (checksum %ld)\n", w.name, threads, rate / 1e6, stats.seconds * 1e9 / double(calls), rate / base,
+						stats.checksum);
+		}
+	}
+	return 0;
+}
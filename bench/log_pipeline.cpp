@@ -0,0 +1,371 @@
+// KT header-only library
+// Requirements: C++17
+// End-to-end pipeline on synthetic log lines, every stage returning kt::result:
+// 	- generate : tab-separated lines (timestamp, level, service, status, latency, bytes, JSON attributes), a share of them
+// 	  deliberately broken at one stage
+// 	- parse : tokenizer, std::from_chars, enum_parse, checked narrowing
+// 	- validate : UTF-8, status and latency ranges
+// 	- enrich : service lookup (hash map) and JSON attribute lookups
+// 	- aggregate : per-service counters (byte counts converted with checked multiplication)
+// Run single-threaded over all lines, then with the lines split across 2, 4, ... N threads (one shard each); aggregates of
+// every run must match
+// Build and run (from the repository root):
+// 	g++ -std=c++17 -O2 -pthread -I. bench/log_pipeline.cpp -o log_pipeline && ./log_pipeline [max_threads] [lines] [error_percent]
+
+#include "checked.hpp"
+#include "enum_parse.hpp"
+#include "json.hpp"
+#include "result.hpp"
+#include "tokenizer.hpp"
+#include "utf8.hpp"
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+enum class level : std::uint8_t { trace, debug, info, warn, error, fatal };
+} // namespace
+
+template <>
+struct kt::enum_names<level> {
+	static constexpr std::array<kt::enum_entry<level>, 6> entries = {{
+		{"TRACE", level::trace},
+		{"DEBUG", level::debug},
+		{"INFO", level::info},
+		{"WARN", level::warn},
+		{"ERROR", level::error},
+		{"FATAL", level::fatal},
+	}};
+};
+
+namespace {
+constexpr std::size_t level_count = 6;
+constexpr std::size_t service_count = 64;
+constexpr std::uint32_t max_latency_us = 60'000'000;
+
+///
+/// \brief Why a line was dropped (the stage that rejected it is implied)
+///
+enum class fault : std::uint8_t {
+	bad_row,		 // parse
+	bad_number,		 // parse
+	unknown_level,	 // parse
+	bad_utf8,		 // validate
+	bad_status,		 // validate
+	unknown_service, // enrich
+	bad_attributes,	 // enrich
+	overflow,		 // aggregate
+};
+constexpr std::size_t fault_count = 8;
+constexpr char const* fault_names[fault_count] = {"bad_row",		 "bad_number",	   "unknown_level", "bad_utf8",
+												  "bad_status",		 "unknown_service", "bad_attributes", "overflow"};
+
+struct record {
+	std::uint64_t timestamp{};
+	level severity{};
+	std::string_view service;
+	std::uint16_t status{};
+	std::uint32_t latency_us{};
+	std::uint64_t bytes{};
+	std::string_view attributes;
+};
+
+struct service_info {
+	std::uint32_t id{};
+	std::uint32_t sla_us{};
+};
+
+struct enriched {
+	record rec;
+	service_info service;
+	std::int64_t retries{};
+	bool has_user{};
+};
+
+struct service_stats {
+	std::uint64_t lines{};
+	std::uint64_t bits{};
+	std::uint64_t latency_us{};
+	std::uint64_t sla_breaches{};
+	std::uint64_t retries{};
+	std::uint64_t anonymous{};
+	std::uint64_t per_level[level_count]{};
+};
+
+struct aggregate {
+	std::vector<service_stats> services = std::vector<service_stats>(service_count);
+	std::uint64_t faults[fault_count]{};
+
+	void merge(aggregate const& rhs) {
+		for (std::size_t s = 0; s < service_count; ++s) {
+			auto& lhs = services[s];
+			auto const& r = rhs.services[s];
+			lhs.lines += r.lines;
+			lhs.bits += r.bits;
+			lhs.latency_us += r.latency_us;
+			lhs.sla_breaches += r.sla_breaches;
+			lhs.retries += r.retries;
+			lhs.anonymous += r.anonymous;
+			for (std::size_t l = 0; l < level_count; ++l) { lhs.per_level[l] += r.per_level[l]; }
+		}
+		for (std::size_t f = 0; f < fault_count; ++f) { faults[f] += rhs.faults[f]; }
+	}
+
+	bool operator==(aggregate const& rhs) const {
+		for (std::size_t s = 0; s < service_count; ++s) {
+			auto const& a = services[s];
+			auto const& b = rhs.services[s];
+			if (a.lines != b.lines || a.bits != b.bits || a.latency_us != b.latency_us || a.sla_breaches != b.sla_breaches || a.retries != b.retries ||
+				a.anonymous != b.anonymous || !std::equal(a.per_level, a.per_level + level_count, b.per_level)) {
+				return false;
+			}
+		}
+		return std::equal(faults, faults + fault_count, rhs.faults);
+	}
+};
+
+using directory = std::unordered_map<std::string_view, service_info>;
+
+// generate
+
+struct rng {
+	std::uint64_t state;
+
+	std::uint64_t next() noexcept {
+		state ^= state << 13;
+		state ^= state >> 7;
+		state ^= state << 17;
+		return state;
+	}
+	std::uint32_t below(std::uint32_t bound) noexcept { return std::uint32_t(next() % bound); }
+};
+
+std::string service_name(std::size_t id) {
+	char buf[16];
+	auto const len = std::snprintf(buf, sizeof(buf), "svc-%02zu", id);
+	return std::string(buf, std::size_t(len));
+}
+
+///
+/// \brief Append count lines to out; error_percent of them break one stage (chosen at random)
+///
+void generate(std::string& out, std::size_t count, std::uint32_t error_percent, std::uint64_t seed) {
+	rng r{seed * 0x9E3779B97F4A7C15ULL + 1};
+	char buf[64];
+	for (std::size_t i = 0; i < count; ++i) {
+		bool const broken = r.below(100) < error_percent;
+		auto const breaks = broken ? fault(r.below(fault_count)) : fault::bad_row;
+		auto const is = [&](fault f) { return broken && breaks == f; };
+
+		out += std::to_string(1'760'000'000'000ULL + i * 7);
+		out += '\t';
+		out += is(fault::unknown_level) ? "NOTICE" : kt::enum_names<level>::entries[r.below(level_count)].name;
+		out += '\t';
+		auto const service = r.below(service_count);
+		out += is(fault::unknown_service) ? std::string("svc-retired") : service_name(service);
+		if (is(fault::bad_utf8)) { out += "\xc3\x28"; }
+		out += '\t';
+		out += std::to_string(is(fault::bad_status) ? 999 : 200 + 100 * r.below(4));
+		out += '\t';
+		out += is(fault::bad_number) ? std::string("12x") : std::to_string(50 + r.below(200'000));
+		out += '\t';
+		out += is(fault::overflow) ? std::string("18446744073709551000") : std::to_string(r.below(1 << 20));
+		if (!is(fault::bad_row)) {
+			out += '\t';
+			auto const len = std::snprintf(buf, sizeof(buf), "{\"user\":\"u%u\",\"retries\":%u", r.below(100'000), r.below(4));
+			out.append(buf, std::size_t(len));
+			out += is(fault::bad_attributes) ? "" : "}";
+		}
+		out += '\n';
+	}
+}
+
+// parse
+
+template <typename T>
+kt::result<T, fault> parse_number(std::string_view str) {
+	T ret{};
+	auto const [ptr, ec] = std::from_chars(str.data(), str.data() + str.size(), ret);
+	if (ec != std::errc{} || ptr != str.data() + str.size()) { return fault::bad_number; }
+	return ret;
+}
+
+kt::result<record, fault> parse(kt::field_span const& fields) {
+	if (fields.size() != 7) { return fault::bad_row; }
+	record ret;
+	auto const timestamp = parse_number<std::uint64_t>(fields[0]);
+	if (!timestamp) { return timestamp.error(); }
+	ret.timestamp = timestamp.value();
+	auto const severity = kt::enum_parse<level>(fields[1]);
+	if (!severity) { return fault::unknown_level; }
+	ret.severity = severity.value();
+	ret.service = fields[2];
+	auto const status = parse_number<std::uint32_t>(fields[3]);
+	auto const latency = parse_number<std::uint32_t>(fields[4]);
+	auto const bytes = parse_number<std::uint64_t>(fields[5]);
+	if (!status || !latency || !bytes) { return fault::bad_number; }
+	auto const narrowed = kt::checked::narrow<std::uint16_t>(status.value());
+	if (!narrowed) { return fault::bad_status; }
+	ret.status = narrowed.value();
+	ret.latency_us = latency.value();
+	ret.bytes = bytes.value();
+	ret.attributes = fields[6];
+	return ret;
+}
+
+// validate
+
+kt::result<record, fault> validate(record const& rec) {
+	if (!kt::utf8::validate(rec.service)) { return fault::bad_utf8; }
+	if (rec.status < 100 || rec.status > 599) { return fault::bad_status; }
+	if (rec.latency_us > max_latency_us) { return fault::bad_number; }
+	return rec;
+}
+
+// enrich
+
+kt::result<enriched, fault> enrich(record const& rec, directory const& services) {
+	auto const it = services.find(rec.service);
+	if (it == services.end()) { return fault::unknown_service; }
+	service_info const* service = &it->second;
+	auto const doc = kt::json_document::parse(rec.attributes);
+	if (!doc) { return fault::bad_attributes; }
+	auto const root = doc.value().root();
+	auto const retries = root["retries"].get_int64();
+	if (!retries) { return fault::bad_attributes; }
+	enriched ret;
+	ret.rec = rec;
+	ret.service = *service;
+	ret.retries = retries.value();
+	ret.has_user = root["user"].get_raw_string().has_value();
+	return ret;
+}
+
+// aggregate
+
+kt::result<std::uint64_t, fault> accumulate(enriched const& in, aggregate& out) {
+	auto const bits = kt::checked::mul<std::uint64_t>(in.rec.bytes, 8);
+	if (!bits) { return fault::overflow; }
+	auto& stats = out.services[in.service.id];
+	stats.bits += bits.value();
+	++stats.lines;
+	stats.latency_us += in.rec.latency_us;
+	stats.sla_breaches += in.rec.latency_us > in.service.sla_us;
+	stats.retries += std::uint64_t(in.retries);
+	stats.anonymous += !in.has_user;
+	++stats.per_level[std::size_t(in.rec.severity)];
+	return stats.lines;
+}
+
+///
+/// \brief parse -> validate -> enrich -> aggregate over every line of text; faults are counted, not fatal
+///
+aggregate run_pipeline(std::string_view text, directory const& services) {
+	aggregate ret;
+	kt::delimited_tokenizer tok(text, kt::delimited_format{'\t', '"', false});
+	while (!tok.at_end()) {
+		auto const row = tok.next_row();
+		if (!row) {
+			++ret.faults[std::size_t(fault::bad_row)];
+			continue;
+		}
+		auto const rec = parse(row.value());
+		auto const valid = rec ? validate(rec.value()) : kt::result<record, fault>(rec.error());
+		auto const rich = valid ? enrich(valid.value(), services) : kt::result<enriched, fault>(valid.error());
+		auto const added = rich ? accumulate(rich.value(), ret) : kt::result<std::uint64_t, fault>(rich.error());
+		if (!added) { ++ret.faults[std::size_t(added.error())]; }
+	}
+	return ret;
+}
+
+///
+/// \brief Run the pipeline over each shard on its own thread (the calling thread takes shard 0); merged aggregate
+///
+aggregate run_sharded(std::vector<std::string> const& shards, directory const& services) {
+	std::vector<aggregate> partial(shards.size());
+	std::vector<std::thread> pool;
+	for (std::size_t s = 1; s < shards.size(); ++s) {
+		pool.emplace_back([&, s] { partial[s] = run_pipeline(shards[s], services); });
+	}
+	partial[0] = run_pipeline(shards[0], services);
+	for (auto& thread : pool) { thread.join(); }
+	aggregate ret;
+	for (auto const& p : partial) { ret.merge(p); }
+	return ret;
+}
+
+template <typename F>
+double seconds(F&& f) {
+	auto const start = std::chrono::steady_clock::now();
+	f();
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+} // namespace
+
+int main(int argc, char** argv) {
+	unsigned const hardware = std::max(1U, std::thread::hardware_concurrency());
+	unsigned const max_threads = argc > 1 ? unsigned(std::strtoul(argv[1], nullptr, 10)) : hardware;
+	std::size_t const lines = argc > 2 ? std::size_t(std::strtoull(argv[2], nullptr, 10)) : 1'000'000;
+	unsigned const error_percent = argc > 3 ? unsigned(std::strtoul(argv[3], nullptr, 10)) : 5;
+	if (max_threads == 0 || lines == 0 || error_percent > 100) {
+		std::fprintf(stderr, "usage: %s [max_threads >= 1] [lines >= 1] [error_percent 0..100]\n", argv[0]);
+		return 1;
+	}
+
+	// names must outlive the directory (it holds views)
+	std::vector<std::string> names(service_count);
+	directory services;
+	for (std::uint32_t id = 0; id < service_count; ++id) {
+		names[id] = service_name(id);
+		services.emplace(names[id], service_info{id, 20'000 + 1'000 * id});
+	}
+
+	std::string text;
+	double const generate_s = seconds([&] { generate(text, lines, error_percent, 1); });
+	double const mb = double(text.size()) / 1e6;
+
+	aggregate reference;
+	double const single_s = seconds([&] { reference = run_pipeline(text, services); });
+
+	std::printf("%zu lines (%.1f MB), %u%% broken, generated in %.3f s\n", lines, mb, error_percent, generate_s);
+	std::printf("%-8s %12s %10s %10s\n", "threads", "Mlines/s", "MB/s", "scaling");
+	std::printf("%-8u %12.3f %10.1f %9.2fx\n", 1U, double(lines) / single_s / 1e6, mb / single_s, 1.0);
+
+	std::vector<unsigned> counts;
+	for (unsigned t = 2; t < max_threads; t *= 2) { counts.push_back(t); }
+	if (max_threads > 1) { counts.push_back(max_threads); }
+
+	int mismatches{};
+	for (unsigned const threads : counts) {
+		// the same lines, split at line boundaries into one shard per thread
+		std::vector<std::string> shards(threads);
+		std::size_t begin{};
+		for (unsigned t = 0; t < threads; ++t) {
+			std::size_t end = t + 1 == threads ? text.size() : text.find('\n', std::max(begin, text.size() * (t + 1) / threads));
+			end = end == std::string::npos ? text.size() : end + (end < text.size());
+			shards[t].assign(text, begin, end - begin);
+			begin = end;
+		}
+		aggregate result;
+		double const s = seconds([&] { result = run_sharded(shards, services); });
+		bool const same = result == reference;
+		mismatches += !same;
+		std::printf("%-8u %12.3f %10.1f %9.2fx%s\n", threads, double(lines) / s / 1e6, mb / s, single_s / s, same ? "" : "   AGGREGATE MISMATCH");
+	}
+
+	std::uint64_t accepted{};
+	for (auto const& stats : reference.services) { accepted += stats.lines; }
+	std::printf("accepted %llu lines; dropped:", static_cast<unsigned long long>(accepted));
+	for (std::size_t f = 0; f < fault_count; ++f) { std::printf(" %s %llu", fault_names[f], static_cast<unsigned long long>(reference.faults[f])); }
+	std::printf("\n");
+	return mismatches == 0 ? 0 : 1;
+}
@@ -0,0 +1,144 @@
+#!/usr/bin/env bash
+# KT header-only library
+# Profile-guided and link-time optimized builds of the benchmarks, reported as deltas against a plain -O2 build
+# Each benchmark is built three ways and run on the same workloads (success and error paths mixed, see RUNS below):
+# 	- base : -O2
+# 	- lto : -O2 -flto
+# 	- pgo : -O2 -flto -fprofile-use, trained by running a -fprofile-generate build on those workloads
+# Variants run REPEAT times (default 3), interleaved, and each number is reduced to its median over the runs
+# The base medians are printed as is; lto and pgo follow with every number that changed replaced by its change relative
+# to base, unchanged numbers kept (mind the unit: ns falling and GB/s or Mcalls/s rising are both improvements)
+# Requires GCC (clang's -fprofile-generate needs an llvm-profdata merge step, which is not done here)
+# Usage (from the repository root):
+# 	bench/pgo.sh [benchmark ...]    (default: all; e.g. bench/pgo.sh log_pipeline)
+# 	CXX, CXXFLAGS (extra flags), REPEAT and OUT (work directory, default _pgo) override the defaults
+
+set -euo pipefail
+
+CXX=${CXX:-g++}
+OUT=${OUT:-_pgo}
+REPEAT=${REPEAT:-3}
+read -r -a EXTRA <<<"${CXXFLAGS:-}"
+COMMON=(-std=c++17 -O2 -pthread -I. "${EXTRA[@]}")
+
+# workloads per benchmark: argument lists separated by ';'
+declare -A RUNS=(
+	[error_scaling]="4 50 200000; --cold 100 32"
+	[log_pipeline]="2 500000 5"
+	[result_layouts]="16"
+)
+
+median() {
+	# $@ : outputs of repeated runs; prints the first with each number replaced by its median over all of them
+	awk -v num='[0-9]+([.][0-9]+)?' '
+		function shape(s) {
+			gsub(num, "#", s)
+			gsub(/[ \t]+/, " ", s)
+			return s
+		}
+		FNR == 1 { ++n }
+		{
+			text[n, FNR] = $0
+			if (FNR > lines) { lines = FNR }
+		}
+		END {
+			for (i = 1; i <= lines; ++i) {
+				same = 1
+				for (f = 2; f <= n; ++f) { if (shape(text[f, i]) != shape(text[1, i])) { same = 0 } }
+				if (!same) { print text[1, i]; continue }
+				for (f = 1; f <= n; ++f) { rest[f] = text[f, i] }
+				out = ""
+				while (match(rest[1], num)) {
+					pre = substr(rest[1], 1, RSTART - 1)
+					tok = substr(rest[1], RSTART, RLENGTH)
+					rest[1] = substr(rest[1], RSTART + RLENGTH)
+					vals[1] = tok + 0
+					equal = 1
+					for (f = 2; f <= n; ++f) {
+						match(rest[f], num)
+						other = substr(rest[f], RSTART, RLENGTH)
+						rest[f] = substr(rest[f], RSTART + RLENGTH)
+						if (other != tok) { equal = 0 }
+						vals[f] = other + 0
+					}
+					if (equal) { out = out pre tok; continue } # keeps counts and checksums exact
+					for (a = 2; a <= n; ++a) {
+						v = vals[a]
+						for (c = a - 1; c >= 1 && vals[c] > v; --c) { vals[c + 1] = vals[c] }
+						vals[c + 1] = v
+					}
+					m = n % 2 ? vals[(n + 1) / 2] : (vals[n / 2] + vals[n / 2 + 1]) / 2
+					dot = index(tok, ".")
+					out = out pre sprintf("%." (dot ? length(tok) - dot : 0) "f", m)
+				}
+				print out rest[1]
+			}
+		}' "$@"
+}
+
+delta() {
+	# $1 : base output, $2 : variant output; lines whose text (numbers aside) differs are printed unchanged
+	awk -v num='[0-9]+([.][0-9]+)?' '
+		function shape(s) {
+			gsub(num, "#", s)
+			gsub(/[ \t]+/, " ", s)
+			return s
+		}
+		NR == FNR { base[FNR] = $0; next }
+		{
+			b = base[FNR]
+			line = $0
+			if (shape(b) != shape(line)) { print line; next }
+			out = ""
+			while (match(line, num)) {
+				pre = substr(line, 1, RSTART - 1)
+				nv = substr(line, RSTART, RLENGTH)
+				line = substr(line, RSTART + RLENGTH)
+				match(b, num)
+				bv = substr(b, RSTART, RLENGTH)
+				b = substr(b, RSTART + RLENGTH)
+				if (nv + 0 == bv + 0 || bv + 0 == 0) { d = nv } else { d = sprintf("%+.1f%%", (nv - bv) * 100 / bv) }
+				out = out pre d
+			}
+			print out line
+		}' "$1" "$2"
+}
+
+if [[ $# -gt 0 ]]; then benches=("$@"); else benches=(error_scaling log_pipeline result_layouts); fi
+mkdir -p "$OUT"
+
+for bench in "${benches[@]}"; do
+	src=bench/$bench.cpp
+	[[ -f $src && -n ${RUNS[$bench]:-} ]] || { echo "unknown benchmark: $bench" >&2; exit 1; }
+	IFS=';' read -r -a runs <<<"${RUNS[$bench]}"
+	profile=$OUT/$bench.profile
+	rm -rf "$profile"
+
+	echo "== $bench: building base, lto, instrumented" >&2
+	"$CXX" "${COMMON[@]}" "$src" -o "$OUT/$bench.base"
+	"$CXX" "${COMMON[@]}" -flto=auto "$src" -o "$OUT/$bench.lto"
+	"$CXX" "${COMMON[@]}" -fprofile-generate="$profile" -fprofile-update=atomic "$src" -o "$OUT/$bench.gen"
+	echo "== $bench: training" >&2
+	for args in "${runs[@]}"; do
+		read -r -a argv <<<"$args"
+		"$OUT/$bench.gen" "${argv[@]}" >/dev/null
+	done
+	echo "== $bench: building pgo" >&2
+	"$CXX" "${COMMON[@]}" -flto=auto -fprofile-use="$profile" -fprofile-correction -Wno-missing-profile "$src" -o "$OUT/$bench.pgo"
+
+	for i in "${!runs[@]}"; do
+		read -r -a argv <<<"${runs[$i]}"
+		rm -f "$OUT/$bench.$i".*.txt
+		for ((r = 0; r < REPEAT; ++r)); do
+			for variant in base lto pgo; do "$OUT/$bench.$variant" "${argv[@]}" >"$OUT/$bench.$i.$variant.$r.txt"; done
+		done
+		for variant in base lto pgo; do median "$OUT/$bench.$i.$variant".*.txt >"$OUT/$bench.$i.$variant.txt"; done
+		echo
+		echo "=== $bench ${runs[$i]# } : base (median of $REPEAT)"
+		cat "$OUT/$bench.$i.base.txt"
+		for variant in lto pgo; do
+			echo "=== $bench ${runs[$i]# } : $variant vs base"
+			delta "$OUT/$bench.$i.base.txt" "$OUT/$bench.$i.$variant.txt"
+		done
+	done
+done
@@ -0,0 +1,408 @@
+// KT header-only library
+// Requirements: C++17; Linux for cache-miss counts (perf_event_open; omitted when unavailable)
+// Memory bandwidth of batch layouts for results: scan (sum ok values), filter (collect failed indices) and
+// compact (copy ok values out) over large arrays, across element sizes and error rates
+// 	- aos : std::vector<kt::result<T, E>>
+// 	- soa : values[] and errors[] (E{} marks success)
+// 	- bitmap : success bitmap, dense ok values, dense errors
+// 	- sparse : values[] for every slot and a sorted (index, error) list
+// GB/s counts the bytes an operation reads (the parts of the layout it needs) plus the bytes it writes; ns/elem compares
+// layouts directly
+// Build and run (from the repository root):
+// 	g++ -std=c++17 -O2 -I. bench/result_layouts.cpp -o result_layouts && ./result_layouts [MiB_per_array]
+
+#include "result.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+#if defined(__linux__) && __has_include(<linux/perf_event.h>)
+#define KT_BENCH_PERF_EVENTS
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace {
+enum class fault : std::uint8_t { none, bad_checksum, out_of_range };
+
+template <std::size_t Size>
+struct payload {
+	static_assert(Size % 4 == 0 && Size >= 4);
+	std::uint32_t words[Size / 4];
+};
+
+///
+/// \brief Deterministic element source: same values and failures for every layout
+///
+struct source {
+	std::uint32_t state;
+	std::uint32_t per_mille;
+
+	bool next_fails() noexcept {
+		state ^= state << 13;
+		state ^= state >> 17;
+		state ^= state << 5;
+		return state % 1000 < per_mille;
+	}
+	fault error() const noexcept { return state & 1 ? fault::bad_checksum : fault::out_of_range; }
+};
+
+inline unsigned trailing_zeros(std::uint64_t word) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+	return unsigned(__builtin_ctzll(word));
+#else
+	unsigned ret{};
+	for (; (word & 1) == 0; word >>= 1) { ++ret; }
+	return ret;
+#endif
+}
+
+template <std::size_t Size>
+payload<Size> make_value(std::size_t i) noexcept {
+	payload<Size> ret{};
+	ret.words[0] = std::uint32_t(i);
+	return ret;
+}
+
+template <typename T>
+struct aos_layout {
+	static constexpr char const* name = "aos";
+	std::vector<kt::result<T, fault>> items;
+
+	void build(std::size_t count, std::uint32_t per_mille) {
+		source src{0x2545F491U, per_mille};
+		items.resize(count);
+		for (std::size_t i = 0; i < count; ++i) {
+			if (src.next_fails()) {
+				items[i] = src.error();
+			} else {
+				items[i] = make_value<sizeof(T)>(i);
+			}
+		}
+	}
+	std::size_t bytes() const noexcept { return items.size() * sizeof(items[0]); }
+	std::size_t scan_bytes() const noexcept { return bytes(); }
+	std::size_t filter_bytes() const noexcept { return bytes(); }
+	std::size_t compact_bytes() const noexcept { return bytes(); }
+
+	std::uint64_t scan() const noexcept {
+		std::uint64_t ret{};
+		for (auto const& item : items) {
+			if (item) { ret += item.value().words[0]; }
+		}
+		return ret;
+	}
+	std::size_t filter(std::uint32_t* out) const noexcept {
+		std::size_t ret{};
+		for (std::size_t i = 0; i < items.size(); ++i) {
+			if (!items[i]) { out[ret++] = std::uint32_t(i); }
+		}
+		return ret;
+	}
+	std::size_t compact(T* out) const noexcept {
+		std::size_t ret{};
+		for (auto const& item : items) {
+			if (item) { out[ret++] = item.value(); }
+		}
+		return ret;
+	}
+};
+
+template <typename T>
+struct soa_layout {
+	static constexpr char const* name = "soa";
+	std::vector<T> values;
+	std::vector<fault> errors;
+
+	void build(std::size_t count, std::uint32_t per_mille) {
+		source src{0x2545F491U, per_mille};
+		values.assign(count, T{});
+		errors.assign(count, fault::none);
+		for (std::size_t i = 0; i < count; ++i) {
+			if (src.next_fails()) {
+				errors[i] = src.error();
+			} else {
+				values[i] = make_value<sizeof(T)>(i);
+			}
+		}
+	}
+	std::size_t bytes() const noexcept { return values.size() * (sizeof(T) + sizeof(fault)); }
+	std::size_t scan_bytes() const noexcept { return bytes(); }
+	std::size_t filter_bytes() const noexcept { return errors.size() * sizeof(fault); }
+	std::size_t compact_bytes() const noexcept { return bytes(); }
+
+	std::uint64_t scan() const noexcept {
+		std::uint64_t ret{};
+		for (std::size_t i = 0; i < values.size(); ++i) { ret += errors[i] == fault::none ? values[i].words[0] : 0; }
+		return ret;
+	}
+	std::size_t filter(std::uint32_t* out) const noexcept {
+		std::size_t ret{};
+		for (std::size_t i = 0; i < errors.size(); ++i) {
+			if (errors[i] != fault::none) { out[ret++] = std::uint32_t(i); }
+		}
+		return ret;
+	}
+	std::size_t compact(T* out) const noexcept {
+		std::size_t ret{};
+		for (std::size_t i = 0; i < values.size(); ++i) {
+			if (errors[i] == fault::none) { out[ret++] = values[i]; }
+		}
+		return ret;
+	}
+};
+
+template <typename T>
+struct bitmap_layout {
+	static constexpr char const* name = "bitmap";
+	std::vector<std::uint64_t> ok;
+	std::vector<T> values;
+	std::vector<fault> errors;
+
+	void build(std::size_t count, std::uint32_t per_mille) {
+		source src{0x2545F491U, per_mille};
+		ok.assign((count + 63) / 64, 0);
+		values.clear();
+		errors.clear();
+		for (std::size_t i = 0; i < count; ++i) {
+			if (src.next_fails()) {
+				errors.push_back(src.error());
+			} else {
+				ok[i / 64] |= std::uint64_t(1) << (i % 64);
+				values.push_back(make_value<sizeof(T)>(i));
+			}
+		}
+	}
+	std::size_t bytes() const noexcept { return ok.size() * sizeof(std::uint64_t) + values.size() * sizeof(T) + errors.size() * sizeof(fault); }
+	std::size_t scan_bytes() const noexcept { return values.size() * sizeof(T); }
+	std::size_t filter_bytes() const noexcept { return ok.size() * sizeof(std::uint64_t); }
+	std::size_t compact_bytes() const noexcept { return values.size() * sizeof(T); }
+
+	std::uint64_t scan() const noexcept {
+		std::uint64_t ret{};
+		for (auto const& value : values) { ret += value.words[0]; }
+		return ret;
+	}
+	std::size_t filter(std::uint32_t* out) const noexcept {
+		std::size_t const count = values.size() + errors.size();
+		std::size_t ret{};
+		for (std::size_t w = 0; w < ok.size(); ++w) {
+			std::uint64_t failed = ~ok[w];
+			if (w + 1 == ok.size() && count % 64 != 0) { failed &= (std::uint64_t(1) << (count % 64)) - 1; }
+			for (; failed != 0; failed &= failed - 1) { out[ret++] = std::uint32_t(w * 64 + std::size_t(trailing_zeros(failed))); }
+		}
+		return ret;
+	}
+	std::size_t compact(T* out) const noexcept {
+		if (!values.empty()) { std::memcpy(out, values.data(), values.size() * sizeof(T)); }
+		return values.size();
+	}
+};
+
+template <typename T>
+struct sparse_layout {
+	static constexpr char const* name = "sparse";
+	std::vector<T> values;
+	std::vector<std::pair<std::uint32_t, fault>> errors;
+
+	void build(std::size_t count, std::uint32_t per_mille) {
+		source src{0x2545F491U, per_mille};
+		values.assign(count, T{});
+		errors.clear();
+		for (std::size_t i = 0; i < count; ++i) {
+			if (src.next_fails()) {
+				errors.emplace_back(std::uint32_t(i), src.error());
+			} else {
+				values[i] = make_value<sizeof(T)>(i);
+			}
+		}
+	}
+	std::size_t bytes() const noexcept { return values.size() * sizeof(T) + errors.size() * sizeof(errors[0]); }
+	std::size_t scan_bytes() const noexcept { return (values.size() - errors.size()) * sizeof(T) + errors.size() * sizeof(errors[0]); }
+	std::size_t filter_bytes() const noexcept { return errors.size() * sizeof(errors[0]); }
+	std::size_t compact_bytes() const noexcept { return scan_bytes(); }
+
+	///
+	/// \brief Invoke f(first, last) for each run of ok slots
+	///
+	template <typename F>
+	void for_each_ok_run(F&& f) const {
+		std::size_t first{};
+		for (auto const& e : errors) {
+			if (e.first > first) { f(first, std::size_t(e.first)); }
+			first = std::size_t(e.first) + 1;
+		}
+		if (first < values.size()) { f(first, values.size()); }
+	}
+
+	std::uint64_t scan() const noexcept {
+		std::uint64_t ret{};
+		for_each_ok_run([&](std::size_t first, std::size_t last) {
+			for (std::size_t i = first; i < last; ++i) { ret += values[i].words[0]; }
+		});
+		return ret;
+	}
+	std::size_t filter(std::uint32_t* out) const noexcept {
+		for (std::size_t i = 0; i < errors.size(); ++i) { out[i] = errors[i].first; }
+		return errors.size();
+	}
+	std::size_t compact(T* out) const noexcept {
+		std::size_t ret{};
+		for_each_ok_run([&](std::size_t first, std::size_t last) {
+			std::memcpy(out + ret, values.data() + first, (last - first) * sizeof(T));
+			ret += last - first;
+		});
+		return ret;
+	}
+};
+
+///
+/// \brief Last-level cache misses of this thread (user space), if the kernel allows it
+///
+class cache_miss_counter {
+  public:
+	cache_miss_counter() noexcept {
+#if defined(KT_BENCH_PERF_EVENTS)
+		perf_event_attr attr{};
+		attr.type = PERF_TYPE_HARDWARE;
+		attr.size = sizeof(attr);
+		attr.config = PERF_COUNT_HW_CACHE_MISSES;
+		attr.disabled = 1;
+		attr.exclude_kernel = 1;
+		attr.exclude_hv = 1;
+		m_fd = int(::syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+#endif
+	}
+	~cache_miss_counter() {
+#if defined(KT_BENCH_PERF_EVENTS)
+		if (m_fd >= 0) { ::close(m_fd); }
+#endif
+	}
+	cache_miss_counter(cache_miss_counter const&) = delete;
+	cache_miss_counter& operator=(cache_miss_counter const&) = delete;
+
+	bool available() const noexcept { return m_fd >= 0; }
+
+	void start() noexcept {
+#if defined(KT_BENCH_PERF_EVENTS)
+		if (m_fd < 0) { return; }
+		::ioctl(m_fd, PERF_EVENT_IOC_RESET, 0);
+		::ioctl(m_fd, PERF_EVENT_IOC_ENABLE, 0);
+#endif
+	}
+	std::uint64_t stop() noexcept {
+		std::uint64_t ret{};
+#if defined(KT_BENCH_PERF_EVENTS)
+		if (m_fd < 0) { return ret; }
+		::ioctl(m_fd, PERF_EVENT_IOC_DISABLE, 0);
+		if (::read(m_fd, &ret, sizeof(ret)) != sizeof(ret)) { ret = 0; }
+#endif
+		return ret;
+	}
+
+  private:
+	int m_fd{-1};
+};
+
+struct measurement {
+	double seconds{};
+	std::uint64_t misses{};
+	std::uint64_t check{};
+};
+
+///
+/// \brief Best of reps passes of f (which returns a checksum)
+///
+template <typename F>
+measurement measure(cache_miss_counter& counter, F&& f) {
+	constexpr int reps = 3;
+	measurement ret{};
+	for (int r = 0; r < reps; ++r) {
+		counter.start();
+		auto const start = std::chrono::steady_clock::now();
+		std::uint64_t const check = f();
+		auto const end = std::chrono::steady_clock::now();
+		std::uint64_t const misses = counter.stop();
+		double const seconds = std::chrono::duration<double>(end - start).count();
+		if (r == 0 || seconds < ret.seconds) { ret = {seconds, misses, check}; }
+	}
+	return ret;
+}
+
+struct expected {
+	std::uint64_t scan{};
+	std::uint64_t filter{};
+	std::uint64_t compact{};
+	bool set{};
+};
+
+int g_mismatches{};
+
+template <template <typename> class Layout, typename T>
+void run_layout(std::size_t count, std::uint32_t per_mille, cache_miss_counter& counter, std::vector<std::uint32_t>& indices, std::vector<T>& dense,
+				expected& expect) {
+	Layout<T> layout;
+	layout.build(count, per_mille);
+	auto const scan = measure(counter, [&] { return layout.scan(); });
+	auto const filter = measure(counter, [&] { return std::uint64_t(layout.filter(indices.data())); });
+	auto const compact = measure(counter, [&] { return std::uint64_t(layout.compact(dense.data())); });
+	if (!expect.set) {
+		expect = {scan.check, filter.check, compact.check, true};
+	} else if (scan.check != expect.scan || filter.check != expect.filter || compact.check != expect.compact) {
+		std::printf("  %s: results differ from aos\n", Layout<T>::name);
+		++g_mismatches;
+	}
+	std::printf("  %-7s %5.1f B/elem", Layout<T>::name, double(layout.bytes()) / double(count));
+	auto const report = [&](char const* op, measurement const& m, std::size_t bytes) {
+		std::printf(" | %s %6.2f ns/elem %6.2f GB/s", op, m.seconds * 1e9 / double(count), double(bytes) / 1e9 / m.seconds);
+		if (counter.available()) { std::printf(" %5.3f miss/elem", double(m.misses) / double(count)); }
+	};
+	report("scan", scan, layout.scan_bytes());
+	report("filter", filter, layout.filter_bytes() + std::size_t(filter.check) * sizeof(std::uint32_t));
+	report("compact", compact, layout.compact_bytes() + std::size_t(compact.check) * sizeof(T));
+	std::printf("\n");
+}
+
+template <std::size_t Size>
+void run_size(std::size_t array_bytes, cache_miss_counter& counter) {
+	using T = payload<Size>;
+	std::size_t const count = array_bytes / Size;
+	std::vector<std::uint32_t> indices(count);
+	std::vector<T> dense(count);
+	for (std::uint32_t const per_mille : {1U, 10U, 100U, 500U}) {
+		std::printf("%zu-byte values, %zu elements, %.1f%% errors\n", Size, count, double(per_mille) / 10);
+		expected expect;
+		run_layout<aos_layout>(count, per_mille, counter, indices, dense, expect);
+		run_layout<soa_layout>(count, per_mille, counter, indices, dense, expect);
+		run_layout<bitmap_layout>(count, per_mille, counter, indices, dense, expect);
+		run_layout<sparse_layout>(count, per_mille, counter, indices, dense, expect);
+	}
+}
+} // namespace
+
+int main(int argc, char** argv) {
+	std::size_t const mib = argc > 1 ? std::size_t(std::strtoull(argv[1], nullptr, 10)) : 64;
+	if (mib == 0) {
+		std::fprintf(stderr, "usage: %s [MiB_per_array >= 1]\n", argv[0]);
+		return 1;
+	}
+	cache_miss_counter counter;
+	std::printf("%zu MiB of values per array; cache-miss counts %s\n", mib,
+				counter.available() ? "from perf_event_open" : "unavailable (perf_event_open denied)");
+	std::size_t const bytes = mib << 20;
+	run_size<4>(bytes, counter);
+	run_size<16>(bytes, counter);
+	run_size<64>(bytes, counter);
+	if (g_mismatches != 0) {
+		std::printf("%d layout result mismatch(es)\n", g_mismatches);
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,207 @@
+// KT header-only library
+// Requirements: C++17
+
+#pragma once
+#include "result.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if defined(_MSC_VER)
+#include <cstdlib>
+#endif
+
+namespace kt {
+enum class byte_order { little, big };
+
+///
+/// \brief Insufficient input: read position and bytes requested
+///
+struct eof_error {
+	std::size_t offset{};
+	std::size_t requested{};
+};
+
+///
+/// \brief Non-owning view of bytes read from a byte_reader
+///
+struct byte_view {
+	std::byte const* data{};
+	std::size_t size{};
+
+	constexpr std::byte const* begin() const noexcept { return data; }
+	constexpr std::byte const* end() const noexcept { return data + size; }
+};
+
+namespace detail {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+inline constexpr byte_order native_byte_order = byte_order::big;
+#else
+inline constexpr byte_order native_byte_order = byte_order::little;
+#endif
+
+template <typename U>
+U byteswap(U u) noexcept {
+	static_assert(std::is_unsigned_v<U>);
+	if constexpr (sizeof(U) == 1) {
+		return u;
+#if defined(__GNUC__) || defined(__clang__)
+	} else if constexpr (sizeof(U) == 2) {
+		return __builtin_bswap16(u);
+	} else if constexpr (sizeof(U) == 4) {
+		return __builtin_bswap32(u);
+	} else if constexpr (sizeof(U) == 8) {
+		return __builtin_bswap64(u);
+#elif defined(_MSC_VER)
+	} else if constexpr (sizeof(U) == 2) {
+		return _byteswap_ushort(u);
+	} else if constexpr (sizeof(U) == 4) {
+		return _byteswap_ulong(u);
+	} else if constexpr (sizeof(U) == 8) {
+		return _byteswap_uint64(u);
+#endif
+	} else {
+		U ret{};
+		for (std::size_t i = 0; i < sizeof(U); ++i) {
+			ret = static_cast<U>((ret << 8) | (u & 0xFF));
+			u = static_cast<U>(u >> 8);
+		}
+		return ret;
+	}
+}
+
+template <std::size_t Size>
+struct uint_of_size;
+template <>
+struct uint_of_size<1> {
+	using type = std::uint8_t;
+};
+template <>
+struct uint_of_size<2> {
+	using type = std::uint16_t;
+};
+template <>
+struct uint_of_size<4> {
+	using type = std::uint32_t;
+};
+template <>
+struct uint_of_size<8> {
+	using type = std::uint64_t;
+};
+
+///
+/// \brief Unchecked load of T stored in Order at ptr
+/// bool is rejected: an untrusted byte other than 0 / 1 copied into a bool is undefined behaviour; read a std::uint8_t
+/// and compare instead
+///
+template <typename T, byte_order Order>
+T load(std::byte const* ptr) noexcept {
+	static_assert(std::is_arithmetic_v<T> || std::is_enum_v<T>, "T must be arithmetic or enum");
+	static_assert(!std::is_same_v<T, bool>, "T = bool is not supported, read std::uint8_t instead");
+	using U = typename uint_of_size<sizeof(T)>::type;
+	U u;
+	std::memcpy(&u, ptr, sizeof(U));
+	if constexpr (Order != native_byte_order) { u = byteswap(u); }
+	T ret;
+	std::memcpy(&ret, &u, sizeof(T));
+	return ret;
+}
+} // namespace detail
+
+///
+/// \brief Bounds-checked cursor over a byte buffer
+/// Use reserve(n) to check a group of reads once; reads through the returned batch are plain loads
+///
+class byte_reader {
+  public:
+	class batch;
+
+	constexpr byte_reader() = default;
+	constexpr byte_reader(std::byte const* data, std::size_t size) noexcept : m_data(data), m_size(size) {}
+
+	constexpr std::size_t position() const noexcept { return m_pos; }
+	constexpr std::size_t remaining() const noexcept { return m_size - m_pos; }
+	constexpr bool at_end() const noexcept { return m_pos == m_size; }
+
+	///
+	/// \brief Read T stored in Order and advance
+	///
+	template <typename T, byte_order Order = byte_order::little>
+	kt::result<T, eof_error> read() noexcept {
+		if (remaining() < sizeof(T)) { return eof_error{m_pos, sizeof(T)}; }
+		T const ret = detail::load<T, Order>(m_data + m_pos);
+		m_pos += sizeof(T);
+		return ret;
+	}
+	///
+	/// \brief Obtain view of next count bytes and advance
+	///
+	kt::result<byte_view, eof_error> read_bytes(std::size_t count) noexcept {
+		if (remaining() < count) { return eof_error{m_pos, count}; }
+		byte_view const ret{m_data + m_pos, count};
+		m_pos += count;
+		return ret;
+	}
+	///
+	/// \brief Advance by count bytes; returns new position
+	///
+	kt::result<std::size_t, eof_error> skip(std::size_t count) noexcept {
+		if (remaining() < count) { return eof_error{m_pos, count}; }
+		m_pos += count;
+		return m_pos;
+	}
+	///
+	/// \brief Check count bytes are available once, consume them, and obtain an unchecked batch over them
+	///
+	kt::result<batch, eof_error> reserve(std::size_t count) noexcept;
+
+  private:
+	std::byte const* m_data{};
+	std::size_t m_size{};
+	std::size_t m_pos{};
+};
+
+///
+/// \brief Pre-checked span of a byte_reader; reads only assert bounds (in debug builds)
+///
+class byte_reader::batch {
+  public:
+	constexpr batch() = default;
+
+	constexpr std::size_t remaining() const noexcept { return m_size - m_pos; }
+
+	template <typename T, byte_order Order = byte_order::little>
+	T read() noexcept {
+		assert(remaining() >= sizeof(T));
+		T const ret = detail::load<T, Order>(m_data + m_pos);
+		m_pos += sizeof(T);
+		return ret;
+	}
+	byte_view read_bytes(std::size_t count) noexcept {
+		assert(remaining() >= count);
+		byte_view const ret{m_data + m_pos, count};
+		m_pos += count;
+		return ret;
+	}
+	void skip(std::size_t count) noexcept {
+		assert(remaining() >= count);
+		m_pos += count;
+	}
+
+  private:
+	constexpr batch(std::byte const* data, std::size_t size) noexcept : m_data(data), m_size(size) {}
+
+	std::byte const* m_data{};
+	std::size_t m_size{};
+	std::size_t m_pos{};
+
+	friend class byte_reader;
+};
+
+inline kt::result<byte_reader::batch, eof_error> byte_reader::reserve(std::size_t count) noexcept {
+	if (remaining() < count) { return eof_error{m_pos, count}; }
+	batch const ret(m_data + m_pos, count);
+	m_pos += count;
+	return ret;
+}
+} // namespace kt
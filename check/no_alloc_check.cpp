@@ -0,0 +1,344 @@
+// KT header-only library
+// Requirements: C++17
+// Verifies that result types, codecs and lookups do not allocate on success or error paths
+// Build and run (from the repository root):
+// 	g++ -std=c++17 -O2 -I. check/no_alloc_check.cpp -o no_alloc_check && ./no_alloc_check
+// Build with -std=c++20 to also cover interleave (coroutine frames)
+
+#define KT_ALLOC_GUARD_IMPLEMENTATION
+#include "alloc_guard.hpp"
+#include "byte_reader.hpp"
+#include "checked.hpp"
+#include "encoding.hpp"
+#include "enum_parse.hpp"
+#include "filtered_lookup.hpp"
+#include "frame.hpp"
+#include "interleave.hpp"
+#include "interned.hpp"
+#include "json.hpp"
+#include "multi_find.hpp"
+#include "persistent_memo.hpp"
+#include "result.hpp"
+#include "simd_result.hpp"
+#include "tls_result.hpp"
+#include "tokenizer.hpp"
+#include "utf8.hpp"
+#include "varint.hpp"
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+
+namespace {
+enum class error { unknown, odd, negative };
+
+struct payload {
+	int a{};
+	double b{};
+};
+
+int g_violations{};
+int g_failures{};
+
+void record_violation(kt::alloc_stats allocated) noexcept {
+	std::printf("    %zu allocation(s), %zu byte(s)\n", allocated.count, allocated.bytes);
+	++g_violations;
+}
+
+///
+/// \brief Run f inside a no_alloc_scope; f returns false if it observed a wrong result
+///
+template <typename F>
+void check(char const* name, F&& f) {
+	int const before = g_violations;
+	bool ok{};
+	{
+		kt::no_alloc_scope const guard;
+		ok = f();
+	}
+	bool const allocated = g_violations != before;
+	if (!ok || allocated) { ++g_failures; }
+	std::printf("%-48s %s\n", name, !ok ? "WRONG RESULT" : allocated ? "ALLOCATED" : "ok");
+}
+
+kt::result<int, error> halve(int x) {
+	if (x % 2 != 0) { return error::odd; }
+	return x / 2;
+}
+
+kt::result<payload, error> make_payload(int x) {
+	if (x < 0) { return error::negative; }
+	return payload{x, x * 0.5};
+}
+
+kt::result<int, std::errc> parse_digit(char c) {
+	if (c < '0' || c > '9') { return std::errc::invalid_argument; }
+	return c - '0';
+}
+
+kt::result<int, int> signed_code(int x) {
+	kt::result<int, int> ret;
+	if (x < 0) {
+		ret.set_error(-x);
+	} else {
+		ret.set_result(x);
+	}
+	return ret;
+}
+
+kt::result<int> positive(int x) {
+	if (x <= 0) { return nullptr; }
+	return x;
+}
+
+kt::tls_result<int, error> tls_halve(int x) {
+	if (x % 2 != 0) { return error::odd; }
+	return x / 2;
+}
+
+#if defined(KT_INTERLEAVE_AVAILABLE)
+kt::lookup_task<int, error> chase(int const* ptr) {
+	co_await kt::prefetch_and_yield{ptr};
+	if (*ptr < 0) { co_return error::negative; }
+	co_return *ptr;
+}
+#endif
+} // namespace
+
+template <>
+struct kt::enum_names<error> {
+	static constexpr std::array<enum_entry<error>, 3> entries = {{{"unknown", error::unknown}, {"odd", error::odd}, {"negative", error::negative}}};
+};
+
+int main() {
+	if (!kt::alloc_hooks_active()) {
+		std::puts("allocation hooks are not active");
+		return 1;
+	}
+	kt::set_alloc_violation_handler(&record_violation);
+
+	// the harness itself must trip on an allocation
+	check("self test (expected to allocate)", [] {
+		std::string const str(100, 'x');
+		return str.size() == 100;
+	});
+	if (g_violations != 1) {
+		std::puts("no_alloc_scope did not report an allocation");
+		return 1;
+	}
+	g_failures = 0;
+
+	check("result<T, E> success / error", [] {
+		auto a = halve(4);
+		auto b = halve(3);
+		auto c = a;
+		c = b;
+		return a.value() == 2 && b.error() == error::odd && c.has_error() && std::move(a).value_or(0) == 2;
+	});
+	check("result<struct, E> success / error", [] {
+		auto a = make_payload(3);
+		auto b = make_payload(-1);
+		return a.value().a == 3 && b.error() == error::negative;
+	});
+	check("result<T, errc> success / error", [] {
+		auto a = parse_digit('7');
+		auto b = parse_digit('x');
+		return a.value() == 7 && b.error() == std::errc::invalid_argument;
+	});
+	check("result<T, T> success / error", [] {
+		auto a = signed_code(5);
+		auto b = signed_code(-5);
+		return a.value() == 5 && b.error() == 5;
+	});
+	check("result<T, void> success / error", [] {
+		auto a = positive(2);
+		auto b = positive(-2);
+		return a.value() == 2 && b.has_error();
+	});
+	check("tls_result success / error", [] {
+		// implicit failures never touch the slot, so they must not clobber a pending error
+		auto const a = tls_halve(8);
+		auto const b = tls_halve(7);
+		kt::tls_result<int, error> const c;
+		kt::tls_result<int, error> const d = nullptr;
+		return a.value() == 4 && c.error() == error::unknown && d.error() == error::unknown && b.error() == error::odd;
+	});
+	check("simd_result and_then / to_results / reduce_ok", [] {
+		float const in[8] = {1, -2, 3, 4, 5, -6, 7, 8};
+		auto const lanes = kt::simd_result<float, 8, error>::load(in).and_then([](float x) { return kt::lane_if(x > 0, x, error::negative); });
+		kt::result<float, error> out[8];
+		lanes.to_results(out);
+		float const sum = lanes.reduce_ok(0.0f, [](float a, float b) { return a + b; });
+		return lanes.count_ok() == 6 && out[1].error() == error::negative && out[2].value() == 3 && sum == 28;
+	});
+	check("simd_result<T, N, T> to_results", [] {
+		int const in[4] = {1, 2, 3, 4};
+		auto lanes = kt::simd_result<int, 4, int>::load(in);
+		lanes.set_error(2, 9);
+		kt::result<int, int> out[4];
+		lanes.to_results(out);
+		return out[0].value() == 1 && out[2].error() == 9;
+	});
+	check("checked arithmetic", [] {
+		auto a = kt::checked::add<int>(1, 2);
+		auto b = kt::checked::mul<int>(1 << 30, 4);
+		auto c = kt::checked::div<int>(1, 0);
+		return a.value() == 3 && b.error() == kt::arith_error::overflow && c.error() == kt::arith_error::divide_by_zero;
+	});
+	check("varint encode / decode / errors", [] {
+		std::uint8_t buf[10];
+		std::size_t length{};
+		auto const written = kt::varint::encode(300, buf);
+		auto const a = kt::varint::decode(buf, written, length);
+		auto const b = kt::varint::decode(buf, 1, length);
+		std::uint8_t const overlong[2] = {0x80, 0x00};
+		auto const c = kt::varint::decode(overlong, 2, length);
+		return a.value() == 300 && b.error().type == kt::varint_error::kind::truncated && c.error().type == kt::varint_error::kind::overlong;
+	});
+	check("utf8 validate / transcode", [] {
+		char16_t out[16];
+		auto const a = kt::utf8::validate("plain and \xc3\xa9");
+		auto const b = kt::utf8::validate("bad \xc3\x28");
+		auto const c = kt::utf8::to_utf16("\xc3\xa9t\xc3\xa9", out, 16);
+		return a.has_value() && b.has_error() && c.value() == 3;
+	});
+	check("base64 / hex encode / decode", [] {
+		std::uint8_t const data[5] = {'h', 'e', 'l', 'l', 'o'};
+		char text[16];
+		std::uint8_t back[16];
+		auto const n = kt::base64::encode(data, 5, text);
+		auto const a = kt::base64::decode(std::string_view(text, n), back, sizeof(back));
+		auto const b = kt::base64::decode("a$==", back, sizeof(back));
+		auto const m = kt::hex::encode(data, 5, text);
+		auto const c = kt::hex::decode(std::string_view(text, m), back, sizeof(back));
+		auto const d = kt::hex::decode("zz", back, sizeof(back));
+		return a.value() == 5 && b.has_error() && c.value() == 5 && d.has_error() && std::memcmp(back, data, 5) == 0;
+	});
+	check("byte_reader read / eof", [] {
+		std::byte const data[6] = {std::byte{1}, std::byte{0}, std::byte{0}, std::byte{0}, std::byte{2}, std::byte{0}};
+		kt::byte_reader reader(data, sizeof(data));
+		auto const a = reader.read<std::uint32_t>();
+		auto const b = reader.read<std::uint32_t>();
+		auto const c = reader.read<std::uint16_t>();
+		return a.value() == 1 && b.has_error() && c.value() == 2 && reader.at_end();
+	});
+	check("frame encode / decode / checksum error", [] {
+		std::uint8_t buf[2 * kt::frame::encoded_size(3)];
+		std::size_t size = kt::frame::encode("abc", 3, buf);
+		size += kt::frame::encode("xyz", 3, buf + size);
+		buf[size - 1] ^= 1;
+		kt::frame_decoder decoder(buf, size);
+		auto const a = decoder.next();
+		auto const b = decoder.next();
+		return a.value().size == 3 && b.error().type == kt::frame_error::kind::checksum_mismatch && decoder.at_end();
+	});
+
+	// the structural index is built up front (it allocates); lookups on it must not
+	std::string_view const json = R"({"a":[1,2,3],"b":"xé","c":{"d":-4}})";
+	auto const doc = kt::json_document::parse(json).value();
+	check("json lookups / errors", [&doc] {
+		auto const root = doc.root();
+		auto const a = root["a"].count_elements();
+		auto const b = root["c"]["d"].get_int64();
+		auto const c = root["b"].get_raw_string();
+		auto const d = root["missing"]["x"].get_int64();
+		auto const e = root["a"].get_int64();
+		return a.value() == 3 && b.value() == -4 && c.value() == "x\xc3\xa9" && d.has_error() && e.has_error();
+	});
+
+	// containers are filled (and caches warmed) up front; steady-state lookups must not allocate
+	kt::flat_table<int, int> table;
+	for (int i = 0; i < 100; ++i) { table.insert_or_assign(i, i * i); }
+	check("flat_table find / multi_find", [&table] {
+		int const keys[4] = {3, 50, 100, -1};
+		kt::result<int const*, kt::miss> out[4];
+		auto const hits = kt::multi_find(table, keys, 4, out);
+		return *table.find(7) == 49 && table.find(200) == nullptr && hits == 2 && *out[1].value() == 2500 && out[2].has_error();
+	});
+
+	kt::blocked_bloom filter(100);
+	kt::filtered_lookup lookup(filter, [&table](int key) -> kt::result<int, error> {
+		if (auto const* found = table.find(key)) { return *found; }
+		return error::unknown;
+	}, error::unknown);
+	for (int i = 0; i < 100; ++i) { lookup.insert(i); }
+	check("filtered_lookup find / find_n", [&lookup] {
+		int const keys[3] = {4, 1000, 99};
+		kt::result<int, error> out[3];
+		auto const hits = lookup.find_n(keys, 3, out);
+		return lookup.find(9).value() == 81 && lookup.find(-5).has_error() && hits == 2 && out[1].has_error() && out[2].value() == 9801;
+	});
+
+	check("enum_parse hit / miss", [] {
+		auto const a = kt::enum_parse<error>("negative");
+		auto const b = kt::enum_parse<error>("even");
+		return a.value() == error::negative && b.error().name == "even";
+	});
+
+	std::string_view const tsv = "a\tb\tc\n1\t2\t3\n\"x\t\"\ty\tz\n4\t\"bad\n";
+	kt::delimited_tokenizer tokenizer(tsv, kt::delimited_format{'\t', '"', true});
+	auto const header = tokenizer.next_row();
+	check("delimited_tokenizer next_row (warm)", [&tokenizer, &header] {
+		// a row's fields are only valid until the next call
+		bool const a = tokenizer.next_row().value()[2] == "3";
+		bool const b = tokenizer.next_row().value()[0] == "x\t";
+		bool const c = tokenizer.next_row().has_error();
+		return header.has_value() && a && b && c && tokenizer.at_end();
+	});
+
+	kt::error_interner<std::string> interner;
+	std::string const message(64, 'e');
+	auto const first = interner.intern(message);
+	check("error_interner intern (already interned)", [&interner, &message, &first] {
+		auto const a = interner.intern(message);
+		auto const b = a;
+		return &a.get() == &first.get() && b.get().size() == 64;
+	});
+
+#if defined(KT_PERSISTENT_MEMO_AVAILABLE)
+	char memo_path[] = "/tmp/kt_no_alloc_check_XXXXXX";
+	int const memo_fd = ::mkstemp(memo_path);
+	if (memo_fd >= 0) {
+		::close(memo_fd);
+		auto opened = kt::persistent_memo<int, int, error>::open(memo_path, 64);
+		if (opened.has_value()) {
+			auto m = std::move(opened).value();
+			m.store(1, 10);
+			m.store(2, error::odd);
+			check("persistent_memo find / get_or_compute (cached)", [&m] {
+				auto const a = m.find(1);
+				auto const b = m.find(2);
+				auto const c = m.get_or_compute(1, [](int) -> kt::result<int, error> { return error::unknown; });
+				return a && a->value() == 10 && b && b->error() == error::odd && c.value() == 10 && !m.find(3);
+			});
+		} else {
+			std::puts("persistent_memo: could not open a temporary file, check skipped");
+		}
+		std::remove(memo_path);
+	}
+#endif
+
+#if defined(KT_INTERLEAVE_AVAILABLE)
+	int const cells[8] = {1, 2, -3, 4, 5, -6, 7, 8};
+	auto const run = [&cells] {
+		kt::result<int, error> out[8];
+		auto const hits = kt::interleave<4>(8, [&cells](std::size_t i) { return chase(&cells[i]); }, out);
+		return hits == 6 && out[2].error() == error::negative && out[7].value() == 8;
+	};
+	// the first batch allocates the coroutine frames; later batches of the same task reuse them
+	bool const warm = run();
+	check("interleave steady state (frame cache)", [&warm, &run] { return warm && run(); });
+#endif
+
+	if (g_failures != 0) {
+		std::printf("%d check(s) failed\n", g_failures);
+		return 1;
+	}
+	std::puts("all checks passed");
+	return 0;
+}
@@ -0,0 +1,46 @@
+// KT header-only library
+// Requirements: C++17
+// T / E matrix of kt::result instantiations for check/size_report.sh: every member of each result<T, E> is explicitly
+// instantiated, so each accessor is emitted out of line (with its storage calls inlined) and nm can attribute its bytes
+// Build (from the repository root):
+// 	g++ -std=c++17 -O2 -c -I. check/size_matrix.cpp -o size_matrix.o
+
+#include "result.hpp"
+#include <cstdint>
+#include <string>
+#include <system_error>
+#include <vector>
+
+namespace kt_size {
+struct payload {
+	std::uint64_t a{};
+	std::uint64_t b{};
+	double c{};
+	std::uint32_t d{};
+};
+enum class code : std::uint8_t { unknown, bad };
+} // namespace kt_size
+
+#define KT_SIZE_MATRIX(X)                                                                                                                            \
+	X(bool, void)                                                                                                                                    \
+	X(int, void)                                                                                                                                     \
+	X(int, int)                                                                                                                                      \
+	X(int, kt_size::code)                                                                                                                            \
+	X(int, std::errc)                                                                                                                                \
+	X(int, std::error_code)                                                                                                                          \
+	X(int, std::string)                                                                                                                              \
+	X(std::uint64_t, std::errc)                                                                                                                      \
+	X(double, kt_size::code)                                                                                                                         \
+	X(kt_size::payload, void)                                                                                                                        \
+	X(kt_size::payload, kt_size::code)                                                                                                               \
+	X(kt_size::payload, std::error_code)                                                                                                             \
+	X(std::string, void)                                                                                                                             \
+	X(std::string, std::string)                                                                                                                      \
+	X(std::string, std::errc)                                                                                                                        \
+	X(std::string, std::error_code)                                                                                                                  \
+	X(std::vector<int>, kt_size::code)                                                                                                               \
+	X(std::vector<int>, std::string)
+
+#define KT_SIZE_INSTANTIATE(T, E) KT_RESULT_INSTANTIATE_TEMPLATE(T, E);
+
+KT_SIZE_MATRIX(KT_SIZE_INSTANTIATE)
@@ -0,0 +1,78 @@
+#!/usr/bin/env bash
+# KT header-only library
+# Per-instantiation code size of kt::result: compiles check/size_matrix.cpp (a T / E matrix with every member explicitly
+# instantiated), attributes the bytes of each emitted kt:: function (nm --size-sort -C) to its class, and prints the
+# total per instantiation followed by the largest functions
+# Fails (exit 1) if any instantiation exceeds LIMIT bytes, so accessor bloat shows up as a regression
+# Usage (from the repository root):
+# 	check/size_report.sh
+# 	CXX, CXXFLAGS (default -O2 -DNDEBUG), LIMIT (bytes, default 1280) and TOP (functions listed, default 10) override the defaults
+
+set -euo pipefail
+
+CXX=${CXX:-g++}
+read -r -a FLAGS <<<"${CXXFLAGS:--O2 -DNDEBUG}"
+LIMIT=${LIMIT:-1280}
+TOP=${TOP:-10}
+
+work=$(mktemp -d)
+trap 'rm -rf "$work"' EXIT
+
+"$CXX" -std=c++17 "${FLAGS[@]}" -I. -c check/size_matrix.cpp -o "$work/size_matrix.o"
+# nm prints "size type name" with --size-sort; keep functions (text symbols) only and shorten library type names
+nm --size-sort -C -t d "$work/size_matrix.o" |
+	awk '$2 ~ /^[TtWw]$/' |
+	sed -e 's/std::__cxx11::basic_string<char, std::char_traits<char>, std::allocator<char> >/std::string/g' \
+		-e 's/, std::allocator<[^<>]*> >/>/g' -e 's/\([^ ]\) >/\1>/g' >"$work/symbols.txt"
+
+awk -v limit="$LIMIT" -v top="$TOP" '
+	# class of a member function: the name up to the last "::" outside template / parameter brackets
+	function owner(name,    i, c, depth, cut) {
+		depth = 0
+		cut = 0
+		for (i = 1; i <= length(name); ++i) {
+			c = substr(name, i, 1)
+			if (c == "<" || c == "(") { ++depth }
+			else if (c == ">" || c == ")") { --depth }
+			else if (depth == 0 && c == ":" && substr(name, i + 1, 1) == ":") { cut = i }
+			if (depth == 0 && c == "(") { break }
+		}
+		return cut ? substr(name, 1, cut - 1) : name
+	}
+	{
+		size = $1 + 0
+		name = $0
+		sub(/^[0-9]+ [A-Za-z] /, "", name)
+		if (name !~ /^kt::/) { other += size; next }
+		cls = owner(name)
+		bytes[cls] += size
+		count[cls]++
+		total += size
+		fn[++n] = sprintf("%6d  %s", size, name)
+	}
+	END {
+		# largest instantiation first
+		m = 0
+		for (cls in bytes) { order[++m] = cls }
+		for (i = 2; i <= m; ++i) {
+			cls = order[i]
+			for (j = i - 1; j >= 1 && bytes[order[j]] < bytes[cls]; --j) { order[j + 1] = order[j] }
+			order[j + 1] = cls
+		}
+		printf "%-64s %7s %8s\n", "instantiation", "bytes", "symbols"
+		for (i = 1; i <= m; ++i) { printf "%-64s %7d %8d\n", order[i], bytes[order[i]], count[order[i]] }
+		printf "%-64s %7d\n", "total kt::", total
+		printf "%-64s %7d\n", "other (library code pulled in)", other
+		print ""
+		print "largest functions:"
+		for (i = n; i > 0 && i > n - top; --i) { print fn[i] }
+		failed = 0
+		for (cls in bytes) {
+			if (bytes[cls] > limit) {
+				if (!failed) { print "" }
+				printf "FAIL %s: %d bytes (limit %d)\n", cls, bytes[cls], limit
+				failed = 1
+			}
+		}
+		exit failed
+	}' "$work/symbols.txt"
@@ -0,0 +1,295 @@
+// KT header-only library
+// Requirements: C++17
+
+#pragma once
+#include "result.hpp"
+#include <cstdint>
+#include <limits>
+
+namespace kt {
+///
+/// \brief Checked arithmetic failure
+///
+enum class arith_error { unknown, overflow, divide_by_zero, narrowing };
+
+///
+/// \brief Checked batch failure: index of first failing lane and its kind
+///
+struct arith_batch_error {
+	std::size_t index{};
+	arith_error type{};
+};
+
+namespace checked {
+template <typename T>
+constexpr kt::result<T, arith_error> add(T a, T b) noexcept;
+template <typename T>
+constexpr kt::result<T, arith_error> sub(T a, T b) noexcept;
+template <typename T>
+constexpr kt::result<T, arith_error> mul(T a, T b) noexcept;
+template <typename T>
+constexpr kt::result<T, arith_error> div(T a, T b) noexcept;
+///
+/// \brief Convert v to To if the value is representable
+///
+template <typename To, typename From>
+constexpr kt::result<To, arith_error> narrow(From v) noexcept;
+
+///
+/// \brief out[i] = a[i] op b[i]; returns count, or the first overflowing index (out is fully written either way)
+/// Lanes are computed branch-free in chunks so the loops vectorize; the first index is located only on failure
+///
+template <typename T>
+kt::result<std::size_t, arith_batch_error> add_n(T const* a, T const* b, T* out, std::size_t count) noexcept;
+template <typename T>
+kt::result<std::size_t, arith_batch_error> sub_n(T const* a, T const* b, T* out, std::size_t count) noexcept;
+template <typename T>
+kt::result<std::size_t, arith_batch_error> mul_n(T const* a, T const* b, T* out, std::size_t count) noexcept;
+
+///
+/// \brief out[i] = a[i] op b[i], overflow[i] = 1 if lane i overflowed; returns number of overflowing lanes
+///
+template <typename T>
+std::size_t add_n(T const* a, T const* b, T* out, std::uint8_t* overflow, std::size_t count) noexcept;
+template <typename T>
+std::size_t sub_n(T const* a, T const* b, T* out, std::uint8_t* overflow, std::size_t count) noexcept;
+template <typename T>
+std::size_t mul_n(T const* a, T const* b, T* out, std::uint8_t* overflow, std::size_t count) noexcept;
+
+///
+/// \brief Exact sum of data[0, count); fails if it is not representable in T
+/// Note: without a wider accumulator (64-bit T and no __int128) an overflowing intermediate sum also fails
+///
+template <typename T>
+kt::result<T, arith_error> sum(T const* data, std::size_t count) noexcept;
+} // namespace checked
+
+namespace detail {
+template <typename T>
+constexpr void assert_checked_integral() noexcept {
+	static_assert(std::is_integral_v<T> && !std::is_same_v<T, bool>, "T must be an integral type");
+}
+
+// Branch-free wrapping ops that report overflow; written without builtins so loops over them vectorize.
+template <typename T>
+constexpr bool checked_add_wrap(T a, T b, T& out) noexcept {
+	using U = std::make_unsigned_t<T>;
+	out = static_cast<T>(static_cast<U>(a) + static_cast<U>(b));
+	if constexpr (std::is_signed_v<T>) {
+		return ((a ^ out) & (b ^ out)) < 0;
+	} else {
+		return out < a;
+	}
+}
+
+template <typename T>
+constexpr bool checked_sub_wrap(T a, T b, T& out) noexcept {
+	using U = std::make_unsigned_t<T>;
+	out = static_cast<T>(static_cast<U>(a) - static_cast<U>(b));
+	if constexpr (std::is_signed_v<T>) {
+		return ((a ^ b) & (a ^ out)) < 0;
+	} else {
+		return a < b;
+	}
+}
+
+template <typename T>
+constexpr bool checked_mul_wrap(T a, T b, T& out) noexcept {
+	if constexpr (sizeof(T) <= 4) {
+		using W = std::conditional_t<std::is_signed_v<T>, std::int64_t, std::uint64_t>;
+		W const wide = static_cast<W>(a) * static_cast<W>(b);
+		out = static_cast<T>(wide);
+		return wide != static_cast<W>(out);
+	} else {
+#if defined(__GNUC__) || defined(__clang__)
+		return __builtin_mul_overflow(a, b, &out);
+#else
+		using U = std::make_unsigned_t<T>;
+		out = static_cast<T>(static_cast<U>(a) * static_cast<U>(b));
+		if (a == 0 || b == 0) { return false; }
+		if constexpr (std::is_signed_v<T>) {
+			if ((a == -1 && b == std::numeric_limits<T>::min()) || (b == -1 && a == std::numeric_limits<T>::min())) { return true; }
+		}
+		return out / b != a;
+#endif
+	}
+}
+
+struct checked_add_op {
+	template <typename T>
+	constexpr bool operator()(T a, T b, T& out) const noexcept {
+		return checked_add_wrap(a, b, out);
+	}
+};
+struct checked_sub_op {
+	template <typename T>
+	constexpr bool operator()(T a, T b, T& out) const noexcept {
+		return checked_sub_wrap(a, b, out);
+	}
+};
+struct checked_mul_op {
+	template <typename T>
+	constexpr bool operator()(T a, T b, T& out) const noexcept {
+		return checked_mul_wrap(a, b, out);
+	}
+};
+
+inline constexpr std::size_t checked_chunk = 256;
+
+template <typename T, typename Op>
+kt::result<std::size_t, arith_batch_error> checked_batch(T const* a, T const* b, T* out, std::size_t count, Op op) noexcept {
+	assert_checked_integral<T>();
+	std::size_t first = count;
+	for (std::size_t base = 0; base < count; base += checked_chunk) {
+		std::size_t const end = count - base < checked_chunk ? count : base + checked_chunk;
+		unsigned flag{};
+		for (std::size_t i = base; i < end; ++i) { flag |= static_cast<unsigned>(op(a[i], b[i], out[i])); }
+		if (flag && first == count) {
+			for (std::size_t i = base; i < end; ++i) {
+				T discard;
+				if (op(a[i], b[i], discard)) {
+					first = i;
+					break;
+				}
+			}
+		}
+	}
+	if (first < count) { return arith_batch_error{first, arith_error::overflow}; }
+	return count;
+}
+
+template <typename T, typename Op>
+std::size_t checked_batch(T const* a, T const* b, T* out, std::uint8_t* overflow, std::size_t count, Op op) noexcept {
+	assert_checked_integral<T>();
+	std::size_t ret{};
+	for (std::size_t i = 0; i < count; ++i) {
+		bool const o = op(a[i], b[i], out[i]);
+		overflow[i] = static_cast<std::uint8_t>(o);
+		ret += static_cast<std::size_t>(o);
+	}
+	return ret;
+}
+} // namespace detail
+
+template <typename T>
+constexpr kt::result<T, arith_error> checked::add(T a, T b) noexcept {
+	detail::assert_checked_integral<T>();
+	T ret{};
+#if defined(__GNUC__) || defined(__clang__)
+	if (__builtin_add_overflow(a, b, &ret)) { return arith_error::overflow; }
+#else
+	if (detail::checked_add_wrap(a, b, ret)) { return arith_error::overflow; }
+#endif
+	return ret;
+}
+
+template <typename T>
+constexpr kt::result<T, arith_error> checked::sub(T a, T b) noexcept {
+	detail::assert_checked_integral<T>();
+	T ret{};
+#if defined(__GNUC__) || defined(__clang__)
+	if (__builtin_sub_overflow(a, b, &ret)) { return arith_error::overflow; }
+#else
+	if (detail::checked_sub_wrap(a, b, ret)) { return arith_error::overflow; }
+#endif
+	return ret;
+}
+
+template <typename T>
+constexpr kt::result<T, arith_error> checked::mul(T a, T b) noexcept {
+	detail::assert_checked_integral<T>();
+	T ret{};
+#if defined(__GNUC__) || defined(__clang__)
+	if (__builtin_mul_overflow(a, b, &ret)) { return arith_error::overflow; }
+#else
+	if (detail::checked_mul_wrap(a, b, ret)) { return arith_error::overflow; }
+#endif
+	return ret;
+}
+
+template <typename T>
+constexpr kt::result<T, arith_error> checked::div(T a, T b) noexcept {
+	detail::assert_checked_integral<T>();
+	if (b == 0) { return arith_error::divide_by_zero; }
+	if constexpr (std::is_signed_v<T>) {
+		if (a == std::numeric_limits<T>::min() && b == -1) { return arith_error::overflow; }
+	}
+	return static_cast<T>(a / b);
+}
+
+template <typename To, typename From>
+constexpr kt::result<To, arith_error> checked::narrow(From v) noexcept {
+	detail::assert_checked_integral<To>();
+	detail::assert_checked_integral<From>();
+	To const ret = static_cast<To>(v);
+	if (static_cast<From>(ret) != v || ((ret < To{}) != (v < From{}))) { return arith_error::narrowing; }
+	return ret;
+}
+
+template <typename T>
+kt::result<std::size_t, arith_batch_error> checked::add_n(T const* a, T const* b, T* out, std::size_t count) noexcept {
+	return detail::checked_batch(a, b, out, count, detail::checked_add_op{});
+}
+
+template <typename T>
+kt::result<std::size_t, arith_batch_error> checked::sub_n(T const* a, T const* b, T* out, std::size_t count) noexcept {
+	return detail::checked_batch(a, b, out, count, detail::checked_sub_op{});
+}
+
+template <typename T>
+kt::result<std::size_t, arith_batch_error> checked::mul_n(T const* a, T const* b, T* out, std::size_t count) noexcept {
+	return detail::checked_batch(a, b, out, count, detail::checked_mul_op{});
+}
+
+template <typename T>
+std::size_t checked::add_n(T const* a, T const* b, T* out, std::uint8_t* overflow, std::size_t count) noexcept {
+	return detail::checked_batch(a, b, out, overflow, count, detail::checked_add_op{});
+}
+
+template <typename T>
+std::size_t checked::sub_n(T const* a, T const* b, T* out, std::uint8_t* overflow, std::size_t count) noexcept {
+	return detail::checked_batch(a, b, out, overflow, count, detail::checked_sub_op{});
+}
+
+template <typename T>
+std::size_t checked::mul_n(T const* a, T const* b, T* out, std::uint8_t* overflow, std::size_t count) noexcept {
+	return detail::checked_batch(a, b, out, overflow, count, detail::checked_mul_op{});
+}
+
+template <typename T>
+kt::result<T, arith_error> checked::sum(T const* data, std::size_t count) noexcept {
+	detail::assert_checked_integral<T>();
+	if constexpr (sizeof(T) <= 4) {
+		// chunks of 2^16 lanes cannot overflow a 64-bit accumulator; the inner loop vectorizes
+		using W = std::conditional_t<std::is_signed_v<T>, std::int64_t, std::uint64_t>;
+		W total{};
+		for (std::size_t base = 0; base < count; base += (std::size_t(1) << 16)) {
+			std::size_t const end = count - base < (std::size_t(1) << 16) ? count : base + (std::size_t(1) << 16);
+			W chunk{};
+			for (std::size_t i = base; i < end; ++i) { chunk += static_cast<W>(data[i]); }
+			auto const next = add(total, chunk);
+			if (!next) { return arith_error::overflow; }
+			total = next.value();
+		}
+		auto const ret = narrow<T>(total);
+		if (!ret) { return arith_error::overflow; }
+		return ret.value();
+	} else {
+#if defined(__SIZEOF_INT128__)
+		__extension__ using int128 = __int128;
+		__extension__ using uint128 = unsigned __int128;
+		using W = std::conditional_t<std::is_signed_v<T>, int128, uint128>;
+		W total{};
+		for (std::size_t i = 0; i < count; ++i) { total += static_cast<W>(data[i]); }
+		if (total > static_cast<W>(std::numeric_limits<T>::max()) || total < static_cast<W>(std::numeric_limits<T>::min())) { return arith_error::overflow; }
+		return static_cast<T>(total);
+#else
+		T total{};
+		bool overflow{};
+		for (std::size_t i = 0; i < count; ++i) { overflow |= detail::checked_add_wrap(total, data[i], total); }
+		if (overflow) { return arith_error::overflow; }
+		return total;
+#endif
+	}
+}
+} // namespace kt
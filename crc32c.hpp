@@ -0,0 +1,162 @@
+// KT header-only library
+// Requirements: C++17
+
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if (defined(__GNUC__) || defined(__clang__)) && defined(__x86_64__)
+#define KT_CRC32C_X86_DISPATCH
+#include <nmmintrin.h>
+#endif
+
+namespace kt {
+///
+/// \brief CRC-32C (Castagnoli) of [data, data + size), continuing from crc (pass a previous result to chain)
+/// Uses SSE4.2 crc32 over three interleaved streams when available at runtime, else slicing-by-8 tables
+///
+std::uint32_t crc32c(void const* data, std::size_t size, std::uint32_t crc = 0) noexcept;
+
+namespace detail {
+inline constexpr std::uint32_t crc32c_poly = 0x82F63B78; // reflected
+
+using crc32c_tables_t = std::array<std::array<std::uint32_t, 256>, 8>;
+
+constexpr crc32c_tables_t make_crc32c_tables() noexcept {
+	crc32c_tables_t ret{};
+	for (std::uint32_t n = 0; n < 256; ++n) {
+		std::uint32_t crc = n;
+		for (int k = 0; k < 8; ++k) { crc = crc & 1 ? (crc >> 1) ^ crc32c_poly : crc >> 1; }
+		ret[0][n] = crc;
+	}
+	for (std::size_t n = 0; n < 256; ++n) {
+		for (std::size_t k = 1; k < 8; ++k) { ret[k][n] = (ret[k - 1][n] >> 8) ^ ret[0][ret[k - 1][n] & 0xFF]; }
+	}
+	return ret;
+}
+
+inline constexpr crc32c_tables_t crc32c_tables = make_crc32c_tables();
+
+///
+/// \brief Software CRC over the raw (non-inverted) register
+///
+inline std::uint32_t crc32c_sw(std::uint32_t crc, std::uint8_t const* ptr, std::size_t size) noexcept {
+	auto const& t = crc32c_tables;
+	for (; size >= 8; size -= 8, ptr += 8) {
+		std::uint32_t lo;
+		std::uint32_t hi;
+		std::memcpy(&lo, ptr, 4);
+		std::memcpy(&hi, ptr + 4, 4);
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+		lo = __builtin_bswap32(lo);
+		hi = __builtin_bswap32(hi);
+#endif
+		lo ^= crc;
+		crc = t[7][lo & 0xFF] ^ t[6][(lo >> 8) & 0xFF] ^ t[5][(lo >> 16) & 0xFF] ^ t[4][lo >> 24] ^ t[3][hi & 0xFF] ^ t[2][(hi >> 8) & 0xFF] ^
+			  t[1][(hi >> 16) & 0xFF] ^ t[0][hi >> 24];
+	}
+	for (; size > 0; --size, ++ptr) { crc = (crc >> 8) ^ t[0][(crc ^ *ptr) & 0xFF]; }
+	return crc;
+}
+
+#if defined(KT_CRC32C_X86_DISPATCH)
+// GF(2) operators that advance a raw CRC register over Len zero bytes, used to merge interleaved streams
+// (after M. Adler, crc32c.c). Built at compile time by repeated squaring of the one-bit operator.
+using crc32c_matrix_t = std::array<std::uint32_t, 32>;
+
+constexpr std::uint32_t crc32c_matrix_times(crc32c_matrix_t const& mat, std::uint32_t vec) noexcept {
+	std::uint32_t ret{};
+	for (std::size_t i = 0; vec; vec >>= 1, ++i) {
+		if (vec & 1) { ret ^= mat[i]; }
+	}
+	return ret;
+}
+
+constexpr crc32c_matrix_t crc32c_matrix_square(crc32c_matrix_t const& mat) noexcept {
+	crc32c_matrix_t ret{};
+	for (std::size_t i = 0; i < 32; ++i) { ret[i] = crc32c_matrix_times(mat, mat[i]); }
+	return ret;
+}
+
+template <std::size_t Len>
+constexpr std::array<std::array<std::uint32_t, 256>, 4> make_crc32c_shift_tables() noexcept {
+	static_assert((Len & (Len - 1)) == 0, "Len must be a power of two");
+	crc32c_matrix_t op{};
+	op[0] = crc32c_poly;
+	for (std::size_t i = 1; i < 32; ++i) { op[i] = std::uint32_t(1) << (i - 1); }
+	for (std::size_t bits = 1; bits < Len * 8; bits *= 2) { op = crc32c_matrix_square(op); }
+	std::array<std::array<std::uint32_t, 256>, 4> ret{};
+	for (std::size_t k = 0; k < 4; ++k) {
+		for (std::uint32_t n = 0; n < 256; ++n) { ret[k][n] = crc32c_matrix_times(op, n << (k * 8)); }
+	}
+	return ret;
+}
+
+inline constexpr std::size_t crc32c_long = 8192;
+inline constexpr std::size_t crc32c_short = 256;
+inline constexpr auto crc32c_long_shift = make_crc32c_shift_tables<crc32c_long>();
+inline constexpr auto crc32c_short_shift = make_crc32c_shift_tables<crc32c_short>();
+
+inline std::uint32_t crc32c_shift(std::array<std::array<std::uint32_t, 256>, 4> const& t, std::uint32_t crc) noexcept {
+	return t[0][crc & 0xFF] ^ t[1][(crc >> 8) & 0xFF] ^ t[2][(crc >> 16) & 0xFF] ^ t[3][crc >> 24];
+}
+
+inline std::uint64_t crc32c_load(std::uint8_t const* ptr) noexcept {
+	std::uint64_t ret;
+	std::memcpy(&ret, ptr, sizeof(ret));
+	return ret;
+}
+
+///
+/// \brief Consume blocks of 3 * Len bytes as three independent crc32 chains, merged with the Len-byte shift operator
+///
+template <std::size_t Len>
+__attribute__((target("sse4.2"))) std::uint32_t crc32c_hw_interleave(std::uint32_t crc, std::uint8_t const*& ptr, std::size_t& size,
+																	  std::array<std::array<std::uint32_t, 256>, 4> const& shift) noexcept {
+	while (size >= Len * 3) {
+		std::uint64_t crc0 = crc;
+		std::uint64_t crc1{};
+		std::uint64_t crc2{};
+		std::uint8_t const* const end = ptr + Len;
+		for (; ptr < end; ptr += 8) {
+			crc0 = _mm_crc32_u64(crc0, crc32c_load(ptr));
+			crc1 = _mm_crc32_u64(crc1, crc32c_load(ptr + Len));
+			crc2 = _mm_crc32_u64(crc2, crc32c_load(ptr + Len * 2));
+		}
+		crc = crc32c_shift(shift, static_cast<std::uint32_t>(crc0)) ^ static_cast<std::uint32_t>(crc1);
+		crc = crc32c_shift(shift, crc) ^ static_cast<std::uint32_t>(crc2);
+		ptr += Len * 2;
+		size -= Len * 3;
+	}
+	return crc;
+}
+
+__attribute__((target("sse4.2"))) inline std::uint32_t crc32c_hw(std::uint32_t crc, std::uint8_t const* ptr, std::size_t size) noexcept {
+	crc = crc32c_hw_interleave<crc32c_long>(crc, ptr, size, crc32c_long_shift);
+	crc = crc32c_hw_interleave<crc32c_short>(crc, ptr, size, crc32c_short_shift);
+	std::uint64_t crc64 = crc;
+	for (; size >= 8; size -= 8, ptr += 8) { crc64 = _mm_crc32_u64(crc64, crc32c_load(ptr)); }
+	crc = static_cast<std::uint32_t>(crc64);
+	for (; size > 0; --size, ++ptr) { crc = _mm_crc32_u8(crc, *ptr); }
+	return crc;
+}
+#endif
+
+using crc32c_fn = std::uint32_t (*)(std::uint32_t, std::uint8_t const*, std::size_t) noexcept;
+
+inline crc32c_fn crc32c_select() noexcept {
+#if defined(KT_CRC32C_X86_DISPATCH)
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("sse4.2")) { return &crc32c_hw; }
+#endif
+	return &crc32c_sw;
+}
+} // namespace detail
+
+inline std::uint32_t crc32c(void const* data, std::size_t size, std::uint32_t crc) noexcept {
+	static detail::crc32c_fn const fn = detail::crc32c_select();
+	return ~fn(~crc, static_cast<std::uint8_t const*>(data), size);
+}
+} // namespace kt
@@ -0,0 +1,329 @@
+// KT header-only library
+// Requirements: C++17
+
+#pragma once
+#include "result.hpp"
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define KT_ENCODING_SSE2
+#include <emmintrin.h>
+#if defined(__SSSE3__)
+#include <tmmintrin.h>
+#endif
+#endif
+
+namespace kt {
+///
+/// \brief Invalid input: offset (in input characters) where decoding failed and its kind
+///
+struct decode_error {
+	enum class kind { unknown, invalid_character, invalid_length, invalid_padding, output_too_small };
+
+	std::size_t offset{};
+	kind type{};
+};
+
+enum class base64_alphabet { standard, url };
+
+namespace base64 {
+constexpr std::size_t encoded_size(std::size_t bytes, bool padding = true) noexcept { return padding ? (bytes + 2) / 3 * 4 : (bytes * 4 + 2) / 3; }
+constexpr std::size_t max_decoded_size(std::size_t chars) noexcept { return chars / 4 * 3 + 2; }
+
+///
+/// \brief Encode size bytes into out (which must hold encoded_size(size, padding) chars); returns chars written
+///
+std::size_t encode(std::uint8_t const* data, std::size_t size, char* out, base64_alphabet alphabet = base64_alphabet::standard, bool padding = true) noexcept;
+///
+/// \brief Decode padded or unpadded input into out; returns bytes written
+///
+kt::result<std::size_t, decode_error> decode(std::string_view in, std::uint8_t* out, std::size_t capacity,
+											 base64_alphabet alphabet = base64_alphabet::standard) noexcept;
+} // namespace base64
+
+namespace hex {
+constexpr std::size_t encoded_size(std::size_t bytes) noexcept { return bytes * 2; }
+constexpr std::size_t max_decoded_size(std::size_t chars) noexcept { return chars / 2; }
+
+///
+/// \brief Encode size bytes into out (which must hold encoded_size(size) chars); returns chars written
+///
+std::size_t encode(std::uint8_t const* data, std::size_t size, char* out, bool upper = false) noexcept;
+///
+/// \brief Decode (case-insensitive) input into out; returns bytes written
+///
+kt::result<std::size_t, decode_error> decode(std::string_view in, std::uint8_t* out, std::size_t capacity) noexcept;
+} // namespace hex
+
+namespace detail {
+constexpr char base64_char62(base64_alphabet alphabet) noexcept { return alphabet == base64_alphabet::url ? '-' : '+'; }
+constexpr char base64_char63(base64_alphabet alphabet) noexcept { return alphabet == base64_alphabet::url ? '_' : '/'; }
+
+constexpr std::array<char, 64> make_base64_encode_table(base64_alphabet alphabet) noexcept {
+	std::array<char, 64> ret{};
+	for (int i = 0; i < 26; ++i) {
+		ret[std::size_t(i)] = char('A' + i);
+		ret[std::size_t(26 + i)] = char('a' + i);
+	}
+	for (int i = 0; i < 10; ++i) { ret[std::size_t(52 + i)] = char('0' + i); }
+	ret[62] = base64_char62(alphabet);
+	ret[63] = base64_char63(alphabet);
+	return ret;
+}
+
+constexpr std::array<std::uint8_t, 256> make_base64_decode_table(base64_alphabet alphabet) noexcept {
+	std::array<std::uint8_t, 256> ret{};
+	for (auto& value : ret) { value = 0xFF; }
+	auto const encode = make_base64_encode_table(alphabet);
+	for (std::size_t i = 0; i < encode.size(); ++i) { ret[static_cast<unsigned char>(encode[i])] = static_cast<std::uint8_t>(i); }
+	return ret;
+}
+
+inline constexpr std::array<std::array<char, 64>, 2> base64_encode_tables = {make_base64_encode_table(base64_alphabet::standard),
+																			 make_base64_encode_table(base64_alphabet::url)};
+inline constexpr std::array<std::array<std::uint8_t, 256>, 2> base64_decode_tables = {make_base64_decode_table(base64_alphabet::standard),
+																					  make_base64_decode_table(base64_alphabet::url)};
+
+constexpr std::uint8_t hex_value(char c) noexcept {
+	if (c >= '0' && c <= '9') { return std::uint8_t(c - '0'); }
+	if (c >= 'a' && c <= 'f') { return std::uint8_t(c - 'a' + 10); }
+	if (c >= 'A' && c <= 'F') { return std::uint8_t(c - 'A' + 10); }
+	return 0xFF;
+}
+
+#if defined(KT_ENCODING_SSE2)
+inline __m128i sse2_in_range(__m128i v, char lo, char hi) noexcept {
+	return _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8(char(lo - 1))), _mm_cmplt_epi8(v, _mm_set1_epi8(char(hi + 1))));
+}
+
+inline __m128i sse2_select(__m128i mask, __m128i a, __m128i b) noexcept { return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b)); }
+
+///
+/// \brief Translate 16 base64 chars to 6-bit values; returns false if any char is outside the alphabet
+///
+inline bool base64_translate16(__m128i in, __m128i& out, char c62, char c63) noexcept {
+	auto const upper = sse2_in_range(in, 'A', 'Z');
+	auto const lower = sse2_in_range(in, 'a', 'z');
+	auto const digit = sse2_in_range(in, '0', '9');
+	auto const is62 = _mm_cmpeq_epi8(in, _mm_set1_epi8(c62));
+	auto const is63 = _mm_cmpeq_epi8(in, _mm_set1_epi8(c63));
+	auto const valid = _mm_or_si128(_mm_or_si128(_mm_or_si128(upper, lower), digit), _mm_or_si128(is62, is63));
+	if (_mm_movemask_epi8(valid) != 0xFFFF) { return false; }
+	auto delta = _mm_and_si128(upper, _mm_set1_epi8(-'A'));
+	delta = _mm_or_si128(delta, _mm_and_si128(lower, _mm_set1_epi8(char(26 - 'a'))));
+	delta = _mm_or_si128(delta, _mm_and_si128(digit, _mm_set1_epi8(char(52 - '0'))));
+	delta = _mm_or_si128(delta, _mm_and_si128(is62, _mm_set1_epi8(char(62 - c62))));
+	delta = _mm_or_si128(delta, _mm_and_si128(is63, _mm_set1_epi8(char(63 - c63))));
+	out = _mm_add_epi8(in, delta);
+	return true;
+}
+
+///
+/// \brief Pack 16 6-bit values into 12 bytes
+///
+inline void base64_pack16(__m128i values, std::uint8_t* out) noexcept {
+	// bytes [a b c d] -> u16 [a<<6|b, c<<6|d] -> u32 (a<<18|b<<12|c<<6|d)
+	auto const pairs = _mm_or_si128(_mm_slli_epi16(_mm_and_si128(values, _mm_set1_epi16(0x00FF)), 6), _mm_srli_epi16(values, 8));
+	auto const quads = _mm_or_si128(_mm_slli_epi32(_mm_and_si128(pairs, _mm_set1_epi32(0xFFFF)), 12), _mm_srli_epi32(pairs, 16));
+#if defined(__SSSE3__)
+	auto const bytes = _mm_shuffle_epi8(quads, _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+	alignas(16) std::uint8_t buf[16];
+	_mm_store_si128(reinterpret_cast<__m128i*>(buf), bytes);
+	std::memcpy(out, buf, 12);
+#else
+	alignas(16) std::uint32_t buf[4];
+	_mm_store_si128(reinterpret_cast<__m128i*>(buf), quads);
+	for (int i = 0; i < 4; ++i) {
+		out[i * 3] = std::uint8_t(buf[i] >> 16);
+		out[i * 3 + 1] = std::uint8_t(buf[i] >> 8);
+		out[i * 3 + 2] = std::uint8_t(buf[i]);
+	}
+#endif
+}
+
+///
+/// \brief Encode 12 bytes (from 24-bit groups in u32 lanes) into 16 chars
+///
+inline void base64_encode12(std::uint8_t const* in, char* out, char c62, char c63) noexcept {
+	auto const v = _mm_setr_epi32(int(std::uint32_t(in[0]) << 16 | std::uint32_t(in[1]) << 8 | in[2]), int(std::uint32_t(in[3]) << 16 | std::uint32_t(in[4]) << 8 | in[5]),
+								  int(std::uint32_t(in[6]) << 16 | std::uint32_t(in[7]) << 8 | in[8]), int(std::uint32_t(in[9]) << 16 | std::uint32_t(in[10]) << 8 | in[11]));
+	auto const six = _mm_set1_epi32(0x3F);
+	auto idx = _mm_and_si128(_mm_srli_epi32(v, 18), six);
+	idx = _mm_or_si128(idx, _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(v, 12), six), 8));
+	idx = _mm_or_si128(idx, _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(v, 6), six), 16));
+	idx = _mm_or_si128(idx, _mm_slli_epi32(_mm_and_si128(v, six), 24));
+	auto delta = _mm_set1_epi8('A');
+	delta = sse2_select(_mm_cmpgt_epi8(idx, _mm_set1_epi8(25)), _mm_set1_epi8(char('a' - 26)), delta);
+	delta = sse2_select(_mm_cmpgt_epi8(idx, _mm_set1_epi8(51)), _mm_set1_epi8(char('0' - 52)), delta);
+	delta = sse2_select(_mm_cmpeq_epi8(idx, _mm_set1_epi8(62)), _mm_set1_epi8(char(c62 - 62)), delta);
+	delta = sse2_select(_mm_cmpeq_epi8(idx, _mm_set1_epi8(63)), _mm_set1_epi8(char(c63 - 63)), delta);
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_add_epi8(idx, delta));
+}
+
+///
+/// \brief Translate 16 hex chars to nibbles; returns false if any char is not a hex digit
+///
+inline bool hex_translate16(__m128i in, __m128i& out) noexcept {
+	auto const digit = sse2_in_range(in, '0', '9');
+	auto const lower = sse2_in_range(in, 'a', 'f');
+	auto const upper = sse2_in_range(in, 'A', 'F');
+	if (_mm_movemask_epi8(_mm_or_si128(_mm_or_si128(digit, lower), upper)) != 0xFFFF) { return false; }
+	auto delta = _mm_and_si128(digit, _mm_set1_epi8(-'0'));
+	delta = _mm_or_si128(delta, _mm_and_si128(lower, _mm_set1_epi8(char(10 - 'a'))));
+	delta = _mm_or_si128(delta, _mm_and_si128(upper, _mm_set1_epi8(char(10 - 'A'))));
+	out = _mm_add_epi8(in, delta);
+	return true;
+}
+
+inline __m128i hex_pack16(__m128i nibbles) noexcept {
+	// u16 [hi lo] -> hi<<4|lo
+	return _mm_or_si128(_mm_slli_epi16(_mm_and_si128(nibbles, _mm_set1_epi16(0x00FF)), 4), _mm_srli_epi16(nibbles, 8));
+}
+
+inline __m128i hex_chars16(__m128i nibbles, char alpha) noexcept {
+	auto const letter = _mm_cmpgt_epi8(nibbles, _mm_set1_epi8(9));
+	auto const delta = sse2_select(letter, _mm_set1_epi8(char(alpha - 10)), _mm_set1_epi8('0'));
+	return _mm_add_epi8(nibbles, delta);
+}
+#endif
+} // namespace detail
+
+inline std::size_t base64::encode(std::uint8_t const* data, std::size_t size, char* out, base64_alphabet alphabet, bool padding) noexcept {
+	auto const& table = detail::base64_encode_tables[std::size_t(alphabet)];
+	std::size_t i{};
+	std::size_t o{};
+#if defined(KT_ENCODING_SSE2)
+	for (; i + 12 <= size; i += 12, o += 16) { detail::base64_encode12(data + i, out + o, table[62], table[63]); }
+#endif
+	for (; i + 3 <= size; i += 3) {
+		std::uint32_t const v = std::uint32_t(data[i]) << 16 | std::uint32_t(data[i + 1]) << 8 | data[i + 2];
+		out[o++] = table[v >> 18];
+		out[o++] = table[(v >> 12) & 0x3F];
+		out[o++] = table[(v >> 6) & 0x3F];
+		out[o++] = table[v & 0x3F];
+	}
+	if (i < size) {
+		std::uint32_t const v = std::uint32_t(data[i]) << 16 | (i + 1 < size ? std::uint32_t(data[i + 1]) << 8 : 0);
+		out[o++] = table[v >> 18];
+		out[o++] = table[(v >> 12) & 0x3F];
+		if (i + 1 < size) {
+			out[o++] = table[(v >> 6) & 0x3F];
+		} else if (padding) {
+			out[o++] = '=';
+		}
+		if (padding) { out[o++] = '='; }
+	}
+	return o;
+}
+
+inline kt::result<std::size_t, decode_error> base64::decode(std::string_view in, std::uint8_t* out, std::size_t capacity, base64_alphabet alphabet) noexcept {
+	using kind = decode_error::kind;
+	auto const& table = detail::base64_decode_tables[std::size_t(alphabet)];
+	std::size_t size = in.size();
+	std::size_t pad{};
+	if (size % 4 == 0) {
+		while (pad < 2 && size > 0 && in[size - 1] == '=') {
+			--size;
+			++pad;
+		}
+	}
+	std::size_t const tail = size % 4;
+	if (tail == 1) { return decode_error{size - 1, kind::invalid_length}; }
+	std::size_t const decoded = size / 4 * 3 + (tail ? tail - 1 : 0);
+	if (decoded > capacity) { return decode_error{0, kind::output_too_small}; }
+	auto const* ptr = reinterpret_cast<std::uint8_t const*>(in.data());
+	std::size_t i{};
+	std::size_t o{};
+#if defined(KT_ENCODING_SSE2)
+	char const c62 = detail::base64_char62(alphabet);
+	char const c63 = detail::base64_char63(alphabet);
+	for (; i + 16 <= size; i += 16, o += 12) {
+		__m128i values;
+		if (!detail::base64_translate16(_mm_loadu_si128(reinterpret_cast<__m128i const*>(ptr + i)), values, c62, c63)) { break; }
+		detail::base64_pack16(values, out + o);
+	}
+#endif
+	for (; i + 4 <= size; i += 4) {
+		std::uint32_t v{};
+		for (std::size_t j = 0; j < 4; ++j) {
+			auto const six = table[ptr[i + j]];
+			if (six == 0xFF) { return decode_error{i + j, kind::invalid_character}; }
+			v = v << 6 | six;
+		}
+		out[o++] = std::uint8_t(v >> 16);
+		out[o++] = std::uint8_t(v >> 8);
+		out[o++] = std::uint8_t(v);
+	}
+	if (tail) {
+		std::uint32_t v{};
+		for (std::size_t j = 0; j < tail; ++j) {
+			auto const six = table[ptr[i + j]];
+			if (six == 0xFF) { return decode_error{i + j, kind::invalid_character}; }
+			v = v << 6 | six;
+		}
+		// non-zero trailing bits would not round-trip: reject as non-canonical
+		std::uint32_t const spare = tail == 2 ? (v & 0x0F) : (v & 0x03);
+		if (spare != 0) { return decode_error{size - 1, kind::invalid_padding}; }
+		if (pad > 0 && tail + pad != 4) { return decode_error{size, kind::invalid_padding}; }
+		if (tail == 2) {
+			out[o++] = std::uint8_t(v >> 4);
+		} else {
+			out[o++] = std::uint8_t(v >> 10);
+			out[o++] = std::uint8_t(v >> 2);
+		}
+	}
+	return o;
+}
+
+inline std::size_t hex::encode(std::uint8_t const* data, std::size_t size, char* out, bool upper) noexcept {
+	char const alpha = upper ? 'A' : 'a';
+	std::size_t i{};
+#if defined(KT_ENCODING_SSE2)
+	for (; i + 16 <= size; i += 16) {
+		auto const v = _mm_loadu_si128(reinterpret_cast<__m128i const*>(data + i));
+		auto const nibble = _mm_set1_epi8(0x0F);
+		auto const hi = _mm_and_si128(_mm_srli_epi16(v, 4), nibble);
+		auto const lo = _mm_and_si128(v, nibble);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(out + i * 2), detail::hex_chars16(_mm_unpacklo_epi8(hi, lo), alpha));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(out + i * 2 + 16), detail::hex_chars16(_mm_unpackhi_epi8(hi, lo), alpha));
+	}
+#endif
+	for (; i < size; ++i) {
+		auto const hi = data[i] >> 4;
+		auto const lo = data[i] & 0x0F;
+		out[i * 2] = char(hi < 10 ? '0' + hi : alpha + hi - 10);
+		out[i * 2 + 1] = char(lo < 10 ? '0' + lo : alpha + lo - 10);
+	}
+	return size * 2;
+}
+
+inline kt::result<std::size_t, decode_error> hex::decode(std::string_view in, std::uint8_t* out, std::size_t capacity) noexcept {
+	using kind = decode_error::kind;
+	if (in.size() % 2 != 0) { return decode_error{in.size() - 1, kind::invalid_length}; }
+	if (in.size() / 2 > capacity) { return decode_error{0, kind::output_too_small}; }
+	std::size_t i{};
+#if defined(KT_ENCODING_SSE2)
+	auto const* ptr = reinterpret_cast<std::uint8_t const*>(in.data());
+	for (; i + 32 <= in.size(); i += 32) {
+		__m128i a;
+		__m128i b;
+		if (!detail::hex_translate16(_mm_loadu_si128(reinterpret_cast<__m128i const*>(ptr + i)), a) ||
+			!detail::hex_translate16(_mm_loadu_si128(reinterpret_cast<__m128i const*>(ptr + i + 16)), b)) {
+			break;
+		}
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(out + i / 2), _mm_packus_epi16(detail::hex_pack16(a), detail::hex_pack16(b)));
+	}
+#endif
+	for (; i < in.size(); i += 2) {
+		auto const hi = detail::hex_value(in[i]);
+		if (hi == 0xFF) { return decode_error{i, kind::invalid_character}; }
+		auto const lo = detail::hex_value(in[i + 1]);
+		if (lo == 0xFF) { return decode_error{i + 1, kind::invalid_character}; }
+		out[i / 2] = std::uint8_t(hi << 4 | lo);
+	}
+	return in.size() / 2;
+}
+} // namespace kt
@@ -0,0 +1,124 @@
+// KT header-only library
+// Requirements: C++17
+
+#pragma once
+#include "result.hpp"
+#include <array>
+#include <cstdint>
+#include <string_view>
+
+namespace kt {
+///
+/// \brief Name / value pair for enum_names<E>::entries
+///
+template <typename E>
+struct enum_entry {
+	std::string_view name{};
+	E value{};
+};
+
+///
+/// \brief Customization point: specialize with a static constexpr std::array<enum_entry<E>, N> entries
+/// Note: names must be unique and non-empty
+///
+template <typename E>
+struct enum_names;
+
+///
+/// \brief Parse failure: the input that matched no name
+///
+struct unknown_name {
+	std::string_view name{};
+};
+
+///
+/// \brief Parse name into E via a perfect hash built at compile time from enum_names<E>::entries
+/// Lookup costs one branch-free key over the first / last 8 bytes, one multiply-shift and one string compare
+///
+template <typename E>
+constexpr kt::result<E, unknown_name> enum_parse(std::string_view name) noexcept;
+
+namespace detail {
+constexpr std::uint64_t enum_hash_key(std::string_view str) noexcept {
+	// always 8 prefix and 8 suffix byte reads: indices are clamped to the last byte (the empty string reads a terminator),
+	// so the loop has a fixed trip count and short names cost the same as long ones
+	std::size_t const size = str.size();
+	char const* data = size == 0 ? "" : str.data();
+	std::size_t const last = size - (size != 0);
+	std::uint64_t prefix{};
+	std::uint64_t suffix{};
+	for (std::size_t i = 0; i < 8; ++i) {
+		std::size_t const j = i < last ? i : last;
+		prefix |= std::uint64_t(static_cast<unsigned char>(data[j])) << (i * 8);
+		suffix |= std::uint64_t(static_cast<unsigned char>(data[last - j])) << (i * 8);
+	}
+	return prefix ^ ((suffix << 29) | (suffix >> 35)) ^ (std::uint64_t(size) * 0x9E3779B97F4A7C15ULL);
+}
+
+constexpr std::uint64_t enum_splitmix(std::uint64_t x) noexcept {
+	x += 0x9E3779B97F4A7C15ULL;
+	x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+	return x ^ (x >> 31);
+}
+
+template <typename E, std::size_t M>
+struct enum_phf {
+	struct slot_t {
+		enum_entry<E> entry{};
+		bool used{};
+	};
+
+	std::uint64_t seed{};
+	unsigned shift{};
+	std::array<slot_t, M> slots{};
+
+	constexpr std::size_t index(std::string_view name) const noexcept { return static_cast<std::size_t>((enum_hash_key(name) * seed) >> shift); }
+};
+
+template <typename E>
+constexpr std::size_t enum_phf_size() noexcept {
+	std::size_t ret = 2;
+	while (ret < enum_names<E>::entries.size() * 2) { ret *= 2; }
+	return ret;
+}
+
+template <typename E>
+constexpr auto make_enum_phf() noexcept {
+	constexpr auto const& entries = enum_names<E>::entries;
+	constexpr std::size_t size = enum_phf_size<E>();
+	enum_phf<E, size> ret{};
+	unsigned bits{};
+	while ((std::size_t(1) << bits) < size) { ++bits; }
+	ret.shift = 64 - bits;
+	for (std::uint64_t attempt = 0; attempt < 100000; ++attempt) {
+		ret.seed = enum_splitmix(attempt) | 1;
+		ret.slots = {};
+		bool perfect = true;
+		for (auto const& entry : entries) {
+			auto& slot = ret.slots[ret.index(entry.name)];
+			if (slot.used) {
+				perfect = false;
+				break;
+			}
+			slot = {entry, true};
+		}
+		if (perfect) { return ret; }
+	}
+	ret.seed = 0;
+	return ret;
+}
+
+template <typename E>
+inline constexpr auto enum_phf_v = make_enum_phf<E>();
+} // namespace detail
+
+template <typename E>
+constexpr kt::result<E, unknown_name> enum_parse(std::string_view name) noexcept {
+	constexpr auto const& phf = detail::enum_phf_v<E>;
+	static_assert(phf.seed != 0, "No perfect hash found: names collide on length and first / last 8 bytes");
+	auto const& slot = phf.slots[phf.index(name)];
+	if (slot.used && slot.entry.name == name) { return slot.entry.value; }
+	return unknown_name{name};
+}
+} // namespace kt
@@ -0,0 +1,240 @@
+// KT header-only library
+// Requirements: C++17
+
+#pragma once
+#include "result.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if (defined(__GNUC__) || defined(__clang__)) && defined(__x86_64__)
+#define KT_BLOOM_X86_DISPATCH
+#include <immintrin.h>
+#endif
+
+namespace kt {
+namespace detail {
+struct alignas(32) bloom_block {
+	std::uint32_t words[8];
+};
+
+struct std_hash {
+	template <typename K>
+	std::size_t operator()(K const& key) const noexcept(noexcept(std::hash<K>{}(key))) {
+		return std::hash<K>{}(key);
+	}
+};
+} // namespace detail
+
+///
+/// \brief Split-block Bloom filter: each key sets 8 bits, one per 32-bit word of a single 32-byte block
+/// A query touches one block (half a cache line); ~10 bits per key gives ~1% false positives
+///
+class blocked_bloom {
+  public:
+	static constexpr std::size_t default_bits_per_key = 10;
+
+	///
+	/// \brief Size for expected_keys at bits_per_key (rounded up to whole blocks)
+	///
+	explicit blocked_bloom(std::size_t expected_keys = 0, std::size_t bits_per_key = default_bits_per_key);
+
+	///
+	/// \brief Add a key by its hash (any 64-bit hash; it is remixed internally)
+	///
+	void insert(std::uint64_t hash) noexcept;
+	///
+	/// \brief False: key was never inserted; true: key may have been inserted
+	///
+	bool may_contain(std::uint64_t hash) const noexcept;
+	///
+	/// \brief Query count hashes, writing 1 (maybe) / 0 (definitely absent) into out; returns number of maybes
+	/// Uses AVX2 when available at runtime
+	///
+	std::size_t may_contain_n(std::uint64_t const* hashes, std::size_t count, std::uint8_t* out) const noexcept;
+
+	std::size_t block_count() const noexcept { return m_blocks.size(); }
+	void clear() noexcept;
+
+  private:
+	std::vector<detail::bloom_block> m_blocks;
+};
+
+///
+/// \brief Bloom filter in front of a result-returning lookup (store(key) -> kt::result<V, E>)
+/// Definite misses return the canned miss error without calling store; keys must be inserted into the filter
+/// (via insert()) when they are added to the store
+///
+template <typename Store, typename E, typename Hash = detail::std_hash>
+class filtered_lookup {
+  public:
+	filtered_lookup(blocked_bloom& filter, Store store, E miss_error, Hash hasher = {})
+		: m_filter(&filter), m_store(std::move(store)), m_hasher(std::move(hasher)), m_miss(std::move(miss_error)) {}
+
+	template <typename K>
+	void insert(K const& key) {
+		m_filter->insert(hash(key));
+	}
+
+	///
+	/// \brief Look up key; store is only called if the filter may contain it
+	///
+	template <typename K>
+	auto find(K const& key) -> std::invoke_result_t<Store&, K const&>;
+
+	///
+	/// \brief Look up count keys, querying the filter in batches; writes one result per key into out, returns number of hits
+	///
+	template <typename K, typename R>
+	std::size_t find_n(K const* keys, std::size_t count, R* out);
+
+	blocked_bloom& filter() const noexcept { return *m_filter; }
+	Store& store() noexcept { return m_store; }
+	Store const& store() const noexcept { return m_store; }
+
+  private:
+	template <typename K>
+	std::uint64_t hash(K const& key) const {
+		return static_cast<std::uint64_t>(m_hasher(key));
+	}
+
+	blocked_bloom* m_filter;
+	Store m_store;
+	Hash m_hasher;
+	E m_miss;
+};
+
+template <typename Store, typename E>
+filtered_lookup(blocked_bloom&, Store, E) -> filtered_lookup<Store, E>;
+
+template <typename Store, typename E, typename Hash>
+filtered_lookup(blocked_bloom&, Store, E, Hash) -> filtered_lookup<Store, E, Hash>;
+
+namespace detail {
+inline constexpr std::uint32_t bloom_salt[8] = {0x47b6137bU, 0x44974d91U, 0x8824ad5bU, 0xa2b7289dU, 0x705495c7U, 0x2df1424bU, 0x9efc4947U, 0x5c6bfb31U};
+
+inline std::uint64_t bloom_mix(std::uint64_t hash) noexcept {
+	// murmur3 finalizer: identity hashes (eg std::hash<int>) still spread over blocks and bits
+	hash ^= hash >> 33;
+	hash *= 0xff51afd7ed558ccdULL;
+	hash ^= hash >> 33;
+	hash *= 0xc4ceb9fe1a85ec53ULL;
+	hash ^= hash >> 33;
+	return hash;
+}
+
+inline std::size_t bloom_block_index(std::uint64_t mixed, std::size_t blocks) noexcept {
+	return static_cast<std::size_t>(((mixed >> 32) * blocks) >> 32);
+}
+
+inline std::uint32_t bloom_bit(std::uint32_t key, std::size_t word) noexcept { return std::uint32_t(1) << ((key * bloom_salt[word]) >> 27); }
+
+using bloom_query_fn = std::size_t (*)(bloom_block const*, std::size_t, std::uint64_t const*, std::size_t, std::uint8_t*) noexcept;
+
+inline bool bloom_contains(bloom_block const& b, std::uint64_t mixed) noexcept {
+	auto const key = static_cast<std::uint32_t>(mixed);
+	bool ret = true;
+	for (std::size_t i = 0; i < 8; ++i) { ret &= (b.words[i] & bloom_bit(key, i)) != 0; }
+	return ret;
+}
+
+inline std::size_t bloom_query_sw(bloom_block const* blocks, std::size_t size, std::uint64_t const* hashes, std::size_t count, std::uint8_t* out) noexcept {
+	std::size_t ret{};
+	for (std::size_t i = 0; i < count; ++i) {
+		auto const mixed = bloom_mix(hashes[i]);
+		out[i] = bloom_contains(blocks[bloom_block_index(mixed, size)], mixed);
+		ret += out[i];
+	}
+	return ret;
+}
+
+#if defined(KT_BLOOM_X86_DISPATCH)
+///
+/// \brief One key per iteration: build the 8 bit masks in a ymm register and test them against the block
+///
+__attribute__((target("avx2"))) inline std::size_t bloom_query_avx2(bloom_block const* blocks, std::size_t size, std::uint64_t const* hashes, std::size_t count,
+																   std::uint8_t* out) noexcept {
+	__m256i const salt = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(bloom_salt));
+	__m256i const ones = _mm256_set1_epi32(1);
+	std::size_t ret{};
+	for (std::size_t i = 0; i < count; ++i) {
+		auto const mixed = bloom_mix(hashes[i]);
+		__m256i const key = _mm256_set1_epi32(static_cast<int>(static_cast<std::uint32_t>(mixed)));
+		__m256i const mask = _mm256_sllv_epi32(ones, _mm256_srli_epi32(_mm256_mullo_epi32(key, salt), 27));
+		__m256i const b = _mm256_load_si256(reinterpret_cast<__m256i const*>(blocks[bloom_block_index(mixed, size)].words));
+		out[i] = static_cast<std::uint8_t>(_mm256_testc_si256(b, mask));
+		ret += out[i];
+	}
+	return ret;
+}
+#endif
+
+inline bloom_query_fn bloom_query_select() noexcept {
+#if defined(KT_BLOOM_X86_DISPATCH)
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx2")) { return &bloom_query_avx2; }
+#endif
+	return &bloom_query_sw;
+}
+} // namespace detail
+
+inline blocked_bloom::blocked_bloom(std::size_t expected_keys, std::size_t bits_per_key) {
+	std::size_t const bits = expected_keys * bits_per_key;
+	m_blocks.resize(bits / 256 + 1);
+	clear();
+}
+
+inline void blocked_bloom::insert(std::uint64_t hash) noexcept {
+	auto const mixed = detail::bloom_mix(hash);
+	auto& b = m_blocks[detail::bloom_block_index(mixed, m_blocks.size())];
+	auto const key = static_cast<std::uint32_t>(mixed);
+	for (std::size_t i = 0; i < 8; ++i) { b.words[i] |= detail::bloom_bit(key, i); }
+}
+
+inline bool blocked_bloom::may_contain(std::uint64_t hash) const noexcept {
+	auto const mixed = detail::bloom_mix(hash);
+	return detail::bloom_contains(m_blocks[detail::bloom_block_index(mixed, m_blocks.size())], mixed);
+}
+
+inline std::size_t blocked_bloom::may_contain_n(std::uint64_t const* hashes, std::size_t count, std::uint8_t* out) const noexcept {
+	static detail::bloom_query_fn const fn = detail::bloom_query_select();
+	return fn(m_blocks.data(), m_blocks.size(), hashes, count, out);
+}
+
+inline void blocked_bloom::clear() noexcept {
+	for (auto& b : m_blocks) { b = {}; }
+}
+
+template <typename Store, typename E, typename Hash>
+template <typename K>
+auto filtered_lookup<Store, E, Hash>::find(K const& key) -> std::invoke_result_t<Store&, K const&> {
+	if (!m_filter->may_contain(hash(key))) { return m_miss; }
+	return m_store(key);
+}
+
+template <typename Store, typename E, typename Hash>
+template <typename K, typename R>
+std::size_t filtered_lookup<Store, E, Hash>::find_n(K const* keys, std::size_t count, R* out) {
+	constexpr std::size_t group = 64;
+	std::uint64_t hashes[group];
+	std::uint8_t maybe[group];
+	std::size_t ret{};
+	for (std::size_t base = 0; base < count; base += group) {
+		std::size_t const n = count - base < group ? count - base : group;
+		for (std::size_t i = 0; i < n; ++i) { hashes[i] = hash(keys[base + i]); }
+		m_filter->may_contain_n(hashes, n, maybe);
+		for (std::size_t i = 0; i < n; ++i) {
+			if (maybe[i]) {
+				out[base + i] = m_store(keys[base + i]);
+				if (out[base + i].has_value()) { ++ret; }
+			} else {
+				out[base + i] = m_miss;
+			}
+		}
+	}
+	return ret;
+}
+} // namespace kt
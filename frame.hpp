@@ -0,0 +1,108 @@
+// KT header-only library
+// Requirements: C++17
+
+#pragma once
+#include "crc32c.hpp"
+#include "result.hpp"
+#include <cstdint>
+#include <cstring>
+
+namespace kt {
+///
+/// \brief Decoded frame payload (points into the decoder's input buffer)
+///
+struct frame_view {
+	std::uint8_t const* data{};
+	std::size_t size{};
+};
+
+///
+/// \brief Invalid frame: offset of its header and kind
+/// 	- checksum_mismatch : frame is skipped, decoding can continue
+/// 	- truncated_header / truncated_payload / too_large : framing is lost, decoder moves to end
+///
+struct frame_error {
+	enum class kind { unknown, truncated_header, truncated_payload, too_large, checksum_mismatch };
+
+	std::size_t offset{};
+	kind type{};
+};
+
+namespace frame {
+///
+/// \brief Frame layout: u32 payload size (LE), u32 CRC-32C of payload (LE), payload
+///
+constexpr std::size_t header_size = 8;
+constexpr std::size_t encoded_size(std::size_t payload) noexcept { return header_size + payload; }
+
+///
+/// \brief Write a frame for payload into out (which must hold encoded_size(size) bytes); returns bytes written
+///
+std::size_t encode(void const* payload, std::uint32_t size, std::uint8_t* out) noexcept;
+} // namespace frame
+
+///
+/// \brief Zero-copy decoder over a buffer of consecutive frames
+///
+class frame_decoder {
+  public:
+	static constexpr std::size_t default_max_payload = std::size_t(64) << 20;
+
+	frame_decoder(std::uint8_t const* data, std::size_t size, std::size_t max_payload = default_max_payload) noexcept
+		: m_data(data), m_size(size), m_max_payload(max_payload) {}
+
+	bool at_end() const noexcept { return m_pos >= m_size; }
+	std::size_t position() const noexcept { return m_pos; }
+
+	///
+	/// \brief Decode and verify the next frame
+	///
+	kt::result<frame_view, frame_error> next() noexcept;
+
+  private:
+	std::uint8_t const* m_data{};
+	std::size_t m_size{};
+	std::size_t m_max_payload{};
+	std::size_t m_pos{};
+};
+
+namespace detail {
+inline void frame_store_u32(std::uint8_t* out, std::uint32_t value) noexcept {
+	for (int i = 0; i < 4; ++i) { out[i] = static_cast<std::uint8_t>(value >> (i * 8)); }
+}
+
+inline std::uint32_t frame_load_u32(std::uint8_t const* in) noexcept {
+	return std::uint32_t(in[0]) | std::uint32_t(in[1]) << 8 | std::uint32_t(in[2]) << 16 | std::uint32_t(in[3]) << 24;
+}
+} // namespace detail
+
+inline std::size_t frame::encode(void const* payload, std::uint32_t size, std::uint8_t* out) noexcept {
+	detail::frame_store_u32(out, size);
+	detail::frame_store_u32(out + 4, crc32c(payload, size));
+	std::memcpy(out + header_size, payload, size);
+	return encoded_size(size);
+}
+
+inline kt::result<frame_view, frame_error> frame_decoder::next() noexcept {
+	using kind = frame_error::kind;
+	std::size_t const offset = m_pos;
+	if (m_size - m_pos < frame::header_size) {
+		m_pos = m_size;
+		return frame_error{offset, kind::truncated_header};
+	}
+	std::size_t const size = detail::frame_load_u32(m_data + m_pos);
+	std::uint32_t const checksum = detail::frame_load_u32(m_data + m_pos + 4);
+	if (size > m_max_payload) {
+		m_pos = m_size;
+		return frame_error{offset, kind::too_large};
+	}
+	if (m_size - m_pos - frame::header_size < size) {
+		m_pos = m_size;
+		return frame_error{offset, kind::truncated_payload};
+	}
+	frame_view const ret{m_data + m_pos + frame::header_size, size};
+	m_pos += frame::header_size + size;
+	if (crc32c(ret.data, ret.size) != checksum) { return frame_error{offset, kind::checksum_mismatch}; }
+	return ret;
+}
+} // namespace kt
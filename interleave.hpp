@@ -0,0 +1,192 @@
+// KT header-only library
+// Requirements: C++20 (coroutines); empty otherwise
+
+#pragma once
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+#include "result.hpp"
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <new>
+#include <utility>
+
+#define KT_INTERLEAVE_AVAILABLE
+
+namespace kt {
+///
+/// \brief Suspendable lookup producing a kt::result<T, E>; resumed by interleave()
+/// Coroutine body: co_await prefetch_and_yield(ptr) before touching cold memory, co_return a T or an E
+///
+template <typename T, typename E>
+class lookup_task;
+
+///
+/// \brief Awaitable that prefetches ptr and suspends, letting other tasks run while the line arrives
+///
+struct prefetch_and_yield {
+	void const* ptr{};
+
+	bool await_ready() const noexcept;
+	void await_suspend(std::coroutine_handle<>) const noexcept {}
+	void await_resume() const noexcept {}
+};
+
+///
+/// \brief Run make(0) .. make(count - 1) (each returning lookup_task<T, E>) interleaved on this thread, Width in flight at a time
+/// Writes each outcome to out[index]; returns number of successes
+///
+template <std::size_t Width = 16, typename T, typename E, typename F>
+std::size_t interleave(std::size_t count, F&& make, kt::result<T, E>* out);
+
+namespace detail {
+///
+/// \brief Per-thread recycler for coroutine frames of a single (most recent) size
+///
+class task_frame_cache {
+  public:
+	static task_frame_cache& instance() noexcept {
+		thread_local task_frame_cache ret;
+		return ret;
+	}
+
+	task_frame_cache() = default;
+	task_frame_cache(task_frame_cache const&) = delete;
+	task_frame_cache& operator=(task_frame_cache const&) = delete;
+	~task_frame_cache() { clear(); }
+
+	void* allocate(std::size_t size) {
+		if (m_head && size == m_size) {
+			auto* ret = m_head;
+			m_head = m_head->next;
+			return ret;
+		}
+		return ::operator new(size);
+	}
+
+	void deallocate(void* ptr, std::size_t size) noexcept {
+		if (size < sizeof(node)) { return ::operator delete(ptr); }
+		if (size != m_size) {
+			clear();
+			m_size = size;
+		}
+		m_head = ::new (ptr) node{m_head};
+	}
+
+  private:
+	struct node {
+		node* next;
+	};
+
+	void clear() noexcept {
+		while (m_head) {
+			auto* next = m_head->next;
+			::operator delete(m_head);
+			m_head = next;
+		}
+	}
+
+	node* m_head{};
+	std::size_t m_size{};
+};
+
+inline void interleave_prefetch(void const* ptr) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+	__builtin_prefetch(ptr);
+#else
+	(void)ptr;
+#endif
+}
+} // namespace detail
+
+template <typename T, typename E>
+class lookup_task {
+  public:
+	struct promise_type {
+		kt::result<T, E> outcome;
+
+		static void* operator new(std::size_t size) { return detail::task_frame_cache::instance().allocate(size); }
+		static void operator delete(void* ptr, std::size_t size) noexcept { detail::task_frame_cache::instance().deallocate(ptr, size); }
+
+		lookup_task get_return_object() noexcept { return lookup_task(std::coroutine_handle<promise_type>::from_promise(*this)); }
+		std::suspend_always initial_suspend() const noexcept { return {}; }
+		std::suspend_always final_suspend() const noexcept { return {}; }
+		void return_value(kt::result<T, E> value) { outcome = std::move(value); }
+		[[noreturn]] void unhandled_exception() const noexcept { std::terminate(); }
+	};
+
+	lookup_task() = default;
+	lookup_task(lookup_task&& rhs) noexcept : m_handle(std::exchange(rhs.m_handle, {})) {}
+	lookup_task& operator=(lookup_task&& rhs) noexcept {
+		if (&rhs != this) {
+			reset();
+			m_handle = std::exchange(rhs.m_handle, {});
+		}
+		return *this;
+	}
+	~lookup_task() { reset(); }
+
+	bool valid() const noexcept { return static_cast<bool>(m_handle); }
+	bool done() const noexcept { return m_handle.done(); }
+	///
+	/// \brief Run until the next suspension point (or completion)
+	///
+	void resume() const { m_handle.resume(); }
+	///
+	/// \brief Move the outcome out of a completed task
+	///
+	kt::result<T, E> take() {
+		assert(valid() && done());
+		return std::move(m_handle.promise().outcome);
+	}
+
+  private:
+	explicit lookup_task(std::coroutine_handle<promise_type> handle) noexcept : m_handle(handle) {}
+
+	void reset() noexcept {
+		if (m_handle) { std::exchange(m_handle, {}).destroy(); }
+	}
+
+	std::coroutine_handle<promise_type> m_handle{};
+};
+
+inline bool prefetch_and_yield::await_ready() const noexcept {
+	detail::interleave_prefetch(ptr);
+	return false;
+}
+
+template <std::size_t Width, typename T, typename E, typename F>
+std::size_t interleave(std::size_t count, F&& make, kt::result<T, E>* out) {
+	static_assert(Width > 0, "Width must be positive");
+	struct slot {
+		lookup_task<T, E> task;
+		std::size_t index{};
+	};
+	slot slots[Width];
+	std::size_t next{};
+	std::size_t active{};
+	std::size_t ret{};
+	for (; active < Width && next < count; ++active, ++next) { slots[active] = {make(next), next}; }
+	// round robin over in-flight tasks; a finished slot is refilled in place, the last one swapped into a hole when input runs out
+	while (active > 0) {
+		for (std::size_t i = 0; i < active;) {
+			auto& s = slots[i];
+			s.task.resume();
+			if (!s.task.done()) {
+				++i;
+				continue;
+			}
+			out[s.index] = s.task.take();
+			if (out[s.index].has_value()) { ++ret; }
+			if (next < count) {
+				s = {make(next), next};
+				++next;
+				++i;
+			} else {
+				s = std::move(slots[--active]);
+			}
+		}
+	}
+	return ret;
+}
+} // namespace kt
+#endif
@@ -0,0 +1,216 @@
+// KT header-only library
+// Requirements: C++17
+
+#pragma once
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+
+namespace kt {
+///
+/// \brief Pool of unique error payloads: equal payloads intern to one shared, refcounted instance
+/// 	- Shared = false : plain refcount, no locking; interner and handles must stay on one thread
+/// 	- Shared = true : atomic refcount, interning and collection lock a mutex
+/// Unreferenced entries stay cached (so an error that recurs does not reallocate) until collect(), which also
+/// runs automatically whenever the pool has doubled since the last collection
+/// The interner must outlive all of its handles
+///
+template <typename Payload, bool Shared = false, typename Hash = std::hash<Payload>, typename Eq = std::equal_to<Payload>>
+class error_interner;
+
+///
+/// \brief Pointer-sized refcounted handle to an interned payload; compares by identity
+///
+template <typename Payload, bool Shared = false, typename Hash = std::hash<Payload>, typename Eq = std::equal_to<Payload>>
+class interned;
+
+template <typename Payload>
+using local_error_interner = error_interner<Payload, false>;
+template <typename Payload>
+using shared_error_interner = error_interner<Payload, true>;
+
+template <typename Payload, bool Shared, typename Hash, typename Eq>
+class interned {
+	using interner_t = error_interner<Payload, Shared, Hash, Eq>;
+	using entry_t = typename interner_t::entry;
+
+  public:
+	using type = Payload;
+
+	///
+	/// \brief Default constructor (null handle)
+	///
+	constexpr interned() = default;
+	interned(interned const& rhs) noexcept : m_entry(rhs.m_entry) {
+		if (m_entry) { interner_t::retain(*m_entry); }
+	}
+	interned(interned&& rhs) noexcept : m_entry(std::exchange(rhs.m_entry, nullptr)) {}
+	interned& operator=(interned rhs) noexcept {
+		std::swap(m_entry, rhs.m_entry);
+		return *this;
+	}
+	~interned() {
+		if (m_entry) { interner_t::release(*m_entry); }
+	}
+
+	explicit operator bool() const noexcept { return m_entry != nullptr; }
+	Payload const& get() const noexcept {
+		assert(m_entry);
+		return m_entry->first;
+	}
+	Payload const& operator*() const noexcept { return get(); }
+	Payload const* operator->() const noexcept { return &get(); }
+
+	friend bool operator==(interned const& lhs, interned const& rhs) noexcept { return lhs.m_entry == rhs.m_entry; }
+	friend bool operator!=(interned const& lhs, interned const& rhs) noexcept { return lhs.m_entry != rhs.m_entry; }
+
+  private:
+	explicit interned(entry_t* entry) noexcept : m_entry(entry) {}
+
+	entry_t* m_entry{};
+
+	friend interner_t;
+};
+
+template <typename Payload, bool Shared, typename Hash, typename Eq>
+class error_interner {
+  public:
+	using handle = interned<Payload, Shared, Hash, Eq>;
+
+	error_interner() = default;
+	error_interner(error_interner const&) = delete;
+	error_interner& operator=(error_interner const&) = delete;
+
+	///
+	/// \brief Per-thread instance (Shared = false) or process-wide instance (Shared = true)
+	///
+	static error_interner& instance();
+
+	///
+	/// \brief Obtain the handle for payload (copied / moved in only if not already interned)
+	///
+	handle intern(Payload const& payload) { return acquire(payload); }
+	handle intern(Payload&& payload) { return acquire(std::move(payload)); }
+	///
+	/// \brief Intern payload and pin it for the lifetime of the interner; the reference stays valid until then
+	///
+	Payload const& intern_immortal(Payload const& payload) {
+		auto pinned = acquire(payload);
+		return std::exchange(pinned.m_entry, nullptr)->first;
+	}
+
+	///
+	/// \brief Destroy entries without handles (pinned entries are kept); returns number destroyed
+	///
+	std::size_t collect();
+	std::size_t size() const;
+
+  private:
+	struct null_mutex {
+		void lock() noexcept {}
+		void unlock() noexcept {}
+	};
+	using counter_t = std::conditional_t<Shared, std::atomic<std::size_t>, std::size_t>;
+	using mutex_t = std::conditional_t<Shared, std::mutex, null_mutex>;
+
+	struct entry_data {
+		counter_t refs{};
+	};
+
+	using map_t = std::unordered_map<Payload, entry_data, Hash, Eq>;
+	using entry = typename map_t::value_type;
+
+	static constexpr std::size_t min_collect_size = 64;
+
+	template <typename P>
+	handle acquire(P&& payload);
+	std::size_t collect_locked();
+	static void retain(entry& e) noexcept;
+	static void release(entry& e) noexcept;
+
+	map_t m_map;
+	std::size_t m_collect_at{min_collect_size};
+	mutable mutex_t m_mutex;
+
+	friend handle;
+};
+
+// impl
+
+template <typename Payload, bool Shared, typename Hash, typename Eq>
+error_interner<Payload, Shared, Hash, Eq>& error_interner<Payload, Shared, Hash, Eq>::instance() {
+	if constexpr (Shared) {
+		static error_interner ret;
+		return ret;
+	} else {
+		thread_local error_interner ret;
+		return ret;
+	}
+}
+
+template <typename Payload, bool Shared, typename Hash, typename Eq>
+std::size_t error_interner<Payload, Shared, Hash, Eq>::collect() {
+	std::lock_guard<mutex_t> lock(m_mutex);
+	return collect_locked();
+}
+
+template <typename Payload, bool Shared, typename Hash, typename Eq>
+std::size_t error_interner<Payload, Shared, Hash, Eq>::size() const {
+	std::lock_guard<mutex_t> lock(m_mutex);
+	return m_map.size();
+}
+
+template <typename Payload, bool Shared, typename Hash, typename Eq>
+template <typename P>
+auto error_interner<Payload, Shared, Hash, Eq>::acquire(P&& payload) -> handle {
+	std::lock_guard<mutex_t> lock(m_mutex);
+	auto it = m_map.find(payload);
+	if (it == m_map.end()) {
+		if (m_map.size() >= m_collect_at) {
+			collect_locked();
+			m_collect_at = m_map.size() * 2 > min_collect_size ? m_map.size() * 2 : min_collect_size;
+		}
+		it = m_map.try_emplace(std::forward<P>(payload)).first;
+	}
+	retain(*it);
+	return handle(&*it);
+}
+
+template <typename Payload, bool Shared, typename Hash, typename Eq>
+std::size_t error_interner<Payload, Shared, Hash, Eq>::collect_locked() {
+	// refs can only rise from zero through acquire(), which holds the lock: a zero seen here is stable
+	std::size_t ret{};
+	for (auto it = m_map.begin(); it != m_map.end();) {
+		if (it->second.refs == 0) {
+			it = m_map.erase(it);
+			++ret;
+		} else {
+			++it;
+		}
+	}
+	return ret;
+}
+
+template <typename Payload, bool Shared, typename Hash, typename Eq>
+void error_interner<Payload, Shared, Hash, Eq>::retain(entry& e) noexcept {
+	if constexpr (Shared) {
+		e.second.refs.fetch_add(1, std::memory_order_relaxed);
+	} else {
+		++e.second.refs;
+	}
+}
+
+template <typename Payload, bool Shared, typename Hash, typename Eq>
+void error_interner<Payload, Shared, Hash, Eq>::release(entry& e) noexcept {
+	if constexpr (Shared) {
+		e.second.refs.fetch_sub(1, std::memory_order_release);
+	} else {
+		--e.second.refs;
+	}
+}
+} // namespace kt
@@ -0,0 +1,626 @@
+// KT header-only library
+// Requirements: C++17
+
+#pragma once
+#include "result.hpp"
+#include <array>
+#include <charconv>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define KT_JSON_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace kt {
+///
+/// \brief Error codes for on-demand JSON access
+///
+enum class json_error {
+	unknown,
+	empty,
+	capacity,
+	unterminated_string,
+	unbalanced,
+	depth_exceeded,
+	invalid_document,
+	incorrect_type,
+	no_such_field,
+	out_of_range,
+	number_error,
+	number_out_of_range,
+	invalid_escape,
+};
+
+///
+/// \brief JSON value type (determined from the first byte only)
+///
+enum class json_type { object, array, string, number, boolean, null };
+
+class json_document;
+
+///
+/// \brief Lazy cursor to a JSON value; nothing is parsed until an accessor is called
+/// Errors propagate through chained lookups: doc.root()["a"]["b"].get_int64()
+///
+class json_value {
+  public:
+	constexpr json_value() = default;
+	constexpr json_value(json_error error) : m_error(error) {}
+
+	constexpr bool has_error() const noexcept { return m_doc == nullptr; }
+	constexpr json_error error() const noexcept { return m_error; }
+
+	kt::result<json_type, json_error> type() const;
+	bool is_null() const;
+
+	kt::result<std::int64_t, json_error> get_int64() const;
+	kt::result<std::uint64_t, json_error> get_uint64() const;
+	kt::result<double, json_error> get_double() const;
+	kt::result<bool, json_error> get_bool() const;
+	///
+	/// \brief Obtain string contents with escape sequences intact (no allocation)
+	///
+	kt::result<std::string_view, json_error> get_raw_string() const;
+	///
+	/// \brief Obtain unescaped string contents
+	///
+	kt::result<std::string, json_error> get_string() const;
+
+	///
+	/// \brief Find field in object (keys are compared raw, escapes intact)
+	///
+	json_value operator[](std::string_view key) const;
+	///
+	/// \brief Obtain element of array (linear scan)
+	///
+	json_value at(std::size_t index) const;
+
+	///
+	/// \brief Invoke f(json_value) for each array element; returns count visited
+	///
+	template <typename F>
+	kt::result<std::size_t, json_error> for_each_element(F&& f) const;
+	///
+	/// \brief Invoke f(std::string_view, json_value) for each object field; returns count visited
+	///
+	template <typename F>
+	kt::result<std::size_t, json_error> for_each_field(F&& f) const;
+	kt::result<std::size_t, json_error> count_elements() const;
+
+  private:
+	constexpr json_value(json_document const* doc, std::uint32_t tok, std::uint32_t pos) : m_doc(doc), m_tok(tok), m_pos(pos) {}
+
+	char front() const;
+	bool is_scalar() const;
+	std::string_view scalar() const;
+	std::uint32_t skip() const;
+
+	json_document const* m_doc{};
+	std::uint32_t m_tok{};
+	std::uint32_t m_pos{};
+	json_error m_error{};
+
+	friend class json_document;
+};
+
+///
+/// \brief Structural index over a JSON buffer (does not own the buffer)
+/// Note: json_values refer to the document; do not move it while they are in use
+///
+class json_document {
+  public:
+	static constexpr std::size_t max_depth = 1024;
+
+	///
+	/// \brief Build structural index and validate strings and bracket nesting
+	///
+	static kt::result<json_document, json_error> parse(std::string_view json);
+
+	json_value root() const;
+	std::string_view text() const noexcept { return m_text; }
+
+  private:
+	json_value value_after(std::uint32_t tok) const;
+	char at(std::uint32_t tok) const { return m_text[m_index[tok]]; }
+	std::uint32_t tokens() const { return static_cast<std::uint32_t>(m_index.size()); }
+
+	std::string_view m_text;
+	std::vector<std::uint32_t> m_index;
+
+	friend class json_value;
+};
+
+namespace detail {
+constexpr bool json_is_ws(char c) noexcept { return c == ' ' || c == '\t' || c == '\n' || c == '\r'; }
+
+inline int json_ctz(std::uint64_t x) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+	return __builtin_ctzll(x);
+#else
+	int ret{};
+	while ((x & 1) == 0) {
+		x >>= 1;
+		++ret;
+	}
+	return ret;
+#endif
+}
+
+inline std::uint64_t json_prefix_xor(std::uint64_t x) noexcept {
+	x ^= x << 1;
+	x ^= x << 2;
+	x ^= x << 4;
+	x ^= x << 8;
+	x ^= x << 16;
+	x ^= x << 32;
+	return x;
+}
+
+struct json_block_masks {
+	std::uint64_t quote{};
+	std::uint64_t backslash{};
+	std::uint64_t op{};
+};
+
+#if defined(KT_JSON_SSE2)
+inline std::uint64_t json_movemask(__m128i a, __m128i b, __m128i c, __m128i d) noexcept {
+	auto const ma = static_cast<std::uint64_t>(static_cast<std::uint32_t>(_mm_movemask_epi8(a)));
+	auto const mb = static_cast<std::uint64_t>(static_cast<std::uint32_t>(_mm_movemask_epi8(b)));
+	auto const mc = static_cast<std::uint64_t>(static_cast<std::uint32_t>(_mm_movemask_epi8(c)));
+	auto const md = static_cast<std::uint64_t>(static_cast<std::uint32_t>(_mm_movemask_epi8(d)));
+	return ma | (mb << 16) | (mc << 32) | (md << 48);
+}
+
+inline __m128i json_op_eq(__m128i v) noexcept {
+	auto ret = _mm_cmpeq_epi8(v, _mm_set1_epi8('{'));
+	ret = _mm_or_si128(ret, _mm_cmpeq_epi8(v, _mm_set1_epi8('}')));
+	ret = _mm_or_si128(ret, _mm_cmpeq_epi8(v, _mm_set1_epi8('[')));
+	ret = _mm_or_si128(ret, _mm_cmpeq_epi8(v, _mm_set1_epi8(']')));
+	ret = _mm_or_si128(ret, _mm_cmpeq_epi8(v, _mm_set1_epi8(':')));
+	return _mm_or_si128(ret, _mm_cmpeq_epi8(v, _mm_set1_epi8(',')));
+}
+
+inline json_block_masks json_classify(char const* block) noexcept {
+	__m128i v[4];
+	for (int i = 0; i < 4; ++i) { v[i] = _mm_loadu_si128(reinterpret_cast<__m128i const*>(block + i * 16)); }
+	auto const quote = _mm_set1_epi8('"');
+	auto const backslash = _mm_set1_epi8('\\');
+	json_block_masks ret;
+	ret.quote = json_movemask(_mm_cmpeq_epi8(v[0], quote), _mm_cmpeq_epi8(v[1], quote), _mm_cmpeq_epi8(v[2], quote), _mm_cmpeq_epi8(v[3], quote));
+	ret.backslash =
+		json_movemask(_mm_cmpeq_epi8(v[0], backslash), _mm_cmpeq_epi8(v[1], backslash), _mm_cmpeq_epi8(v[2], backslash), _mm_cmpeq_epi8(v[3], backslash));
+	ret.op = json_movemask(json_op_eq(v[0]), json_op_eq(v[1]), json_op_eq(v[2]), json_op_eq(v[3]));
+	return ret;
+}
+#else
+inline json_block_masks json_classify(char const* block) noexcept {
+	json_block_masks ret;
+	for (int i = 0; i < 64; ++i) {
+		auto const bit = std::uint64_t(1) << i;
+		switch (block[i]) {
+		case '"': ret.quote |= bit; break;
+		case '\\': ret.backslash |= bit; break;
+		case '{':
+		case '}':
+		case '[':
+		case ']':
+		case ':':
+		case ',': ret.op |= bit; break;
+		default: break;
+		}
+	}
+	return ret;
+}
+#endif
+
+///
+/// \brief Mask of characters escaped by a preceding backslash (backslashes are rare: loop over set bits)
+///
+inline std::uint64_t json_escaped(std::uint64_t backslash, std::uint64_t& carry) noexcept {
+	std::uint64_t ret = carry;
+	if (carry) { backslash &= ~std::uint64_t(1); }
+	carry = 0;
+	while (backslash) {
+		int const i = json_ctz(backslash);
+		if (i == 63) {
+			carry = 1;
+			break;
+		}
+		ret |= std::uint64_t(1) << (i + 1);
+		backslash &= ~(std::uint64_t(3) << i);
+	}
+	return ret;
+}
+
+inline void json_append_bits(std::vector<std::uint32_t>& out, std::uint64_t bits, std::uint32_t base) {
+	while (bits) {
+		out.push_back(base + static_cast<std::uint32_t>(json_ctz(bits)));
+		bits &= bits - 1;
+	}
+}
+
+inline json_error json_check_nesting(std::string_view text, std::vector<std::uint32_t> const& index) noexcept {
+	std::array<std::uint64_t, json_document::max_depth / 64> is_object{};
+	std::size_t depth{};
+	for (auto const pos : index) {
+		char const c = text[pos];
+		if (c == '{' || c == '[') {
+			if (depth >= json_document::max_depth) { return json_error::depth_exceeded; }
+			auto const bit = std::uint64_t(1) << (depth % 64);
+			if (c == '{') {
+				is_object[depth / 64] |= bit;
+			} else {
+				is_object[depth / 64] &= ~bit;
+			}
+			++depth;
+		} else if (c == '}' || c == ']') {
+			if (depth == 0) { return json_error::unbalanced; }
+			--depth;
+			bool const object = (is_object[depth / 64] >> (depth % 64)) & 1;
+			if (object != (c == '}')) { return json_error::unbalanced; }
+		}
+	}
+	return depth == 0 ? json_error::unknown : json_error::unbalanced;
+}
+
+inline kt::result<std::uint64_t, json_error> json_parse_digits(std::string_view digits) {
+	if (digits.empty()) { return json_error::number_error; }
+	if (digits.size() > 1 && digits[0] == '0') { return json_error::number_error; }
+	std::uint64_t ret{};
+	for (char const c : digits) {
+		if (c < '0' || c > '9') { return c == '.' || c == 'e' || c == 'E' ? json_error::incorrect_type : json_error::number_error; }
+		auto const digit = static_cast<std::uint64_t>(c - '0');
+		if (ret > (std::numeric_limits<std::uint64_t>::max() - digit) / 10) { return json_error::number_out_of_range; }
+		ret = ret * 10 + digit;
+	}
+	return ret;
+}
+
+inline bool json_valid_number(std::string_view str) noexcept {
+	std::size_t i{};
+	auto digits = [&] {
+		std::size_t const start = i;
+		while (i < str.size() && str[i] >= '0' && str[i] <= '9') { ++i; }
+		return i - start;
+	};
+	if (i < str.size() && str[i] == '-') { ++i; }
+	std::size_t const int_start = i;
+	std::size_t const int_digits = digits();
+	if (int_digits == 0 || (int_digits > 1 && str[int_start] == '0')) { return false; }
+	if (i < str.size() && str[i] == '.') {
+		++i;
+		if (digits() == 0) { return false; }
+	}
+	if (i < str.size() && (str[i] == 'e' || str[i] == 'E')) {
+		++i;
+		if (i < str.size() && (str[i] == '+' || str[i] == '-')) { ++i; }
+		if (digits() == 0) { return false; }
+	}
+	return i == str.size();
+}
+
+inline int json_hex(char c) noexcept {
+	if (c >= '0' && c <= '9') { return c - '0'; }
+	if (c >= 'a' && c <= 'f') { return c - 'a' + 10; }
+	if (c >= 'A' && c <= 'F') { return c - 'A' + 10; }
+	return -1;
+}
+
+inline bool json_read_u16(std::string_view str, std::size_t i, std::uint32_t& out) noexcept {
+	if (i + 4 > str.size()) { return false; }
+	out = 0;
+	for (std::size_t j = i; j < i + 4; ++j) {
+		int const h = json_hex(str[j]);
+		if (h < 0) { return false; }
+		out = (out << 4) | static_cast<std::uint32_t>(h);
+	}
+	return true;
+}
+
+inline void json_append_utf8(std::string& out, std::uint32_t cp) {
+	if (cp < 0x80) {
+		out += static_cast<char>(cp);
+	} else if (cp < 0x800) {
+		out += static_cast<char>(0xC0 | (cp >> 6));
+		out += static_cast<char>(0x80 | (cp & 0x3F));
+	} else if (cp < 0x10000) {
+		out += static_cast<char>(0xE0 | (cp >> 12));
+		out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+		out += static_cast<char>(0x80 | (cp & 0x3F));
+	} else {
+		out += static_cast<char>(0xF0 | (cp >> 18));
+		out += static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+		out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+		out += static_cast<char>(0x80 | (cp & 0x3F));
+	}
+}
+} // namespace detail
+
+inline kt::result<json_document, json_error> json_document::parse(std::string_view json) {
+	if (json.size() >= std::numeric_limits<std::uint32_t>::max()) { return json_error::capacity; }
+	std::size_t first{};
+	while (first < json.size() && detail::json_is_ws(json[first])) { ++first; }
+	if (first == json.size()) { return json_error::empty; }
+	json_document ret;
+	ret.m_text = json;
+	ret.m_index.reserve(json.size() / 8 + 8);
+	std::uint64_t escape_carry{};
+	std::uint64_t in_string{};
+	char tail[64];
+	for (std::size_t base = 0; base < json.size(); base += 64) {
+		char const* block = json.data() + base;
+		if (json.size() - base < 64) {
+			std::memset(tail, ' ', sizeof(tail));
+			std::memcpy(tail, block, json.size() - base);
+			block = tail;
+		}
+		auto const masks = detail::json_classify(block);
+		auto const escaped = detail::json_escaped(masks.backslash, escape_carry);
+		auto const quotes = masks.quote & ~escaped;
+		auto const string_mask = detail::json_prefix_xor(quotes) ^ in_string;
+		in_string = static_cast<std::uint64_t>(static_cast<std::int64_t>(string_mask) >> 63);
+		detail::json_append_bits(ret.m_index, (masks.op & ~string_mask) | quotes, static_cast<std::uint32_t>(base));
+	}
+	if (in_string) { return json_error::unterminated_string; }
+	if (auto const err = detail::json_check_nesting(json, ret.m_index); err != json_error::unknown) { return err; }
+	return ret;
+}
+
+inline json_value json_document::root() const {
+	std::uint32_t pos{};
+	while (pos < m_text.size() && detail::json_is_ws(m_text[pos])) { ++pos; }
+	if (pos == m_text.size()) { return json_error::empty; }
+	return json_value(this, 0, pos);
+}
+
+inline json_value json_document::value_after(std::uint32_t tok) const {
+	std::uint32_t pos = m_index[tok] + 1;
+	while (pos < m_text.size() && detail::json_is_ws(m_text[pos])) { ++pos; }
+	if (pos == m_text.size() || m_text[pos] == ',' || m_text[pos] == ':') { return json_error::invalid_document; }
+	return json_value(this, tok + 1, pos);
+}
+
+inline char json_value::front() const { return m_doc->m_text[m_pos]; }
+
+inline bool json_value::is_scalar() const { return m_tok >= m_doc->tokens() || m_doc->m_index[m_tok] != m_pos; }
+
+inline std::string_view json_value::scalar() const {
+	auto const& doc = *m_doc;
+	std::size_t end = m_tok < doc.tokens() ? doc.m_index[m_tok] : doc.m_text.size();
+	while (end > m_pos && detail::json_is_ws(doc.m_text[end - 1])) { --end; }
+	return doc.m_text.substr(m_pos, end - m_pos);
+}
+
+inline std::uint32_t json_value::skip() const {
+	auto const& doc = *m_doc;
+	if (is_scalar()) { return m_tok; }
+	char const c = doc.at(m_tok);
+	if (c == '"') { return m_tok + 2; }
+	if (c != '{' && c != '[') { return m_tok; }
+	std::size_t depth{};
+	for (std::uint32_t t = m_tok; t < doc.tokens(); ++t) {
+		char const d = doc.at(t);
+		if (d == '{' || d == '[') {
+			++depth;
+		} else if ((d == '}' || d == ']') && --depth == 0) {
+			return t + 1;
+		}
+	}
+	return doc.tokens();
+}
+
+inline kt::result<json_type, json_error> json_value::type() const {
+	if (has_error()) { return m_error; }
+	switch (front()) {
+	case '{': return json_type::object;
+	case '[': return json_type::array;
+	case '"': return json_type::string;
+	case 't':
+	case 'f': return json_type::boolean;
+	case 'n': return json_type::null;
+	case '-': return json_type::number;
+	default: break;
+	}
+	if (front() >= '0' && front() <= '9') { return json_type::number; }
+	return json_error::invalid_document;
+}
+
+inline bool json_value::is_null() const { return !has_error() && is_scalar() && scalar() == "null"; }
+
+inline kt::result<std::int64_t, json_error> json_value::get_int64() const {
+	if (has_error()) { return m_error; }
+	if (!is_scalar()) { return json_error::incorrect_type; }
+	auto str = scalar();
+	bool const negative = !str.empty() && str[0] == '-';
+	if (negative) { str.remove_prefix(1); }
+	auto const digits = detail::json_parse_digits(str);
+	if (!digits) { return digits.error(); }
+	constexpr auto max = static_cast<std::uint64_t>(std::numeric_limits<std::int64_t>::max());
+	if (digits.value() > max + (negative ? 1 : 0)) { return json_error::number_out_of_range; }
+	if (negative) { return static_cast<std::int64_t>(std::uint64_t(0) - digits.value()); }
+	return static_cast<std::int64_t>(digits.value());
+}
+
+inline kt::result<std::uint64_t, json_error> json_value::get_uint64() const {
+	if (has_error()) { return m_error; }
+	if (!is_scalar()) { return json_error::incorrect_type; }
+	auto const str = scalar();
+	if (!str.empty() && str[0] == '-') { return detail::json_valid_number(str) ? json_error::number_out_of_range : json_error::number_error; }
+	return detail::json_parse_digits(str);
+}
+
+inline kt::result<double, json_error> json_value::get_double() const {
+	if (has_error()) { return m_error; }
+	if (!is_scalar()) { return json_error::incorrect_type; }
+	auto const str = scalar();
+	if (!detail::json_valid_number(str)) { return str == "true" || str == "false" || str == "null" ? json_error::incorrect_type : json_error::number_error; }
+	double ret{};
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+	auto const [ptr, ec] = std::from_chars(str.data(), str.data() + str.size(), ret);
+	if (ec == std::errc::result_out_of_range) { return json_error::number_out_of_range; }
+	if (ec != std::errc{} || ptr != str.data() + str.size()) { return json_error::number_error; }
+#else
+	char buf[128];
+	if (str.size() >= sizeof(buf)) { return json_error::number_error; }
+	std::memcpy(buf, str.data(), str.size());
+	buf[str.size()] = '\0';
+	ret = std::strtod(buf, nullptr);
+#endif
+	return ret;
+}
+
+inline kt::result<bool, json_error> json_value::get_bool() const {
+	if (has_error()) { return m_error; }
+	if (!is_scalar()) { return json_error::incorrect_type; }
+	auto const str = scalar();
+	if (str == "true") { return true; }
+	if (str == "false") { return false; }
+	return json_error::incorrect_type;
+}
+
+inline kt::result<std::string_view, json_error> json_value::get_raw_string() const {
+	if (has_error()) { return m_error; }
+	if (front() != '"') { return json_error::incorrect_type; }
+	auto const& doc = *m_doc;
+	auto const end = doc.m_index[m_tok + 1];
+	return doc.m_text.substr(m_pos + 1, end - m_pos - 1);
+}
+
+inline kt::result<std::string, json_error> json_value::get_string() const {
+	auto const raw = get_raw_string();
+	if (!raw) { return raw.error(); }
+	auto const str = raw.value();
+	std::string ret;
+	ret.reserve(str.size());
+	for (std::size_t i = 0; i < str.size(); ++i) {
+		if (str[i] != '\\') {
+			ret += str[i];
+			continue;
+		}
+		if (++i == str.size()) { return json_error::invalid_escape; }
+		switch (str[i]) {
+		case '"': ret += '"'; break;
+		case '\\': ret += '\\'; break;
+		case '/': ret += '/'; break;
+		case 'b': ret += '\b'; break;
+		case 'f': ret += '\f'; break;
+		case 'n': ret += '\n'; break;
+		case 'r': ret += '\r'; break;
+		case 't': ret += '\t'; break;
+		case 'u': {
+			std::uint32_t cp{};
+			if (!detail::json_read_u16(str, i + 1, cp)) { return json_error::invalid_escape; }
+			i += 4;
+			if (cp >= 0xD800 && cp < 0xDC00) {
+				std::uint32_t low{};
+				if (i + 2 >= str.size() || str[i + 1] != '\\' || str[i + 2] != 'u' || !detail::json_read_u16(str, i + 3, low)) {
+					return json_error::invalid_escape;
+				}
+				if (low < 0xDC00 || low >= 0xE000) { return json_error::invalid_escape; }
+				cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+				i += 6;
+			} else if (cp >= 0xDC00 && cp < 0xE000) {
+				return json_error::invalid_escape;
+			}
+			detail::json_append_utf8(ret, cp);
+			break;
+		}
+		default: return json_error::invalid_escape;
+		}
+	}
+	return ret;
+}
+
+inline json_value json_value::operator[](std::string_view key) const {
+	json_value ret;
+	auto const visited = for_each_field([&ret, key](std::string_view k, json_value v) {
+		if (k != key) { return true; }
+		ret = v;
+		return false;
+	});
+	if (!visited) { return visited.error(); }
+	if (ret.has_error()) { return json_error::no_such_field; }
+	return ret;
+}
+
+inline json_value json_value::at(std::size_t index) const {
+	json_value ret;
+	std::size_t i{};
+	auto const count = for_each_element([&](json_value v) {
+		if (i++ < index) { return true; }
+		ret = v;
+		return false;
+	});
+	if (!count) { return count.error(); }
+	if (ret.has_error()) { return json_error::out_of_range; }
+	return ret;
+}
+
+template <typename F>
+kt::result<std::size_t, json_error> json_value::for_each_element(F&& f) const {
+	if (has_error()) { return m_error; }
+	if (front() != '[') { return json_error::incorrect_type; }
+	auto const& doc = *m_doc;
+	std::size_t ret{};
+	json_value value = doc.value_after(m_tok);
+	if (value.has_error()) { return value.error(); }
+	if (value.front() == ']') { return ret; }
+	while (true) {
+		++ret;
+		if constexpr (std::is_same_v<std::invoke_result_t<F, json_value>, bool>) {
+			if (!f(value)) { return ret; }
+		} else {
+			f(value);
+		}
+		auto const next = value.skip();
+		if (next >= doc.tokens()) { return json_error::invalid_document; }
+		char const c = doc.at(next);
+		if (c == ']') { return ret; }
+		if (c != ',') { return json_error::invalid_document; }
+		value = doc.value_after(next);
+		if (value.has_error()) { return value.error(); }
+		if (value.front() == ']' || value.front() == '}') { return json_error::invalid_document; }
+	}
+}
+
+template <typename F>
+kt::result<std::size_t, json_error> json_value::for_each_field(F&& f) const {
+	if (has_error()) { return m_error; }
+	if (front() != '{') { return json_error::incorrect_type; }
+	auto const& doc = *m_doc;
+	std::size_t ret{};
+	std::uint32_t tok = m_tok + 1;
+	if (tok < doc.tokens() && doc.at(tok) == '}') { return ret; }
+	while (true) {
+		if (tok + 2 >= doc.tokens() || doc.at(tok) != '"' || doc.at(tok + 2) != ':') { return json_error::invalid_document; }
+		auto const key_begin = doc.m_index[tok] + 1;
+		auto const key = doc.m_text.substr(key_begin, doc.m_index[tok + 1] - key_begin);
+		auto const value = doc.value_after(tok + 2);
+		if (value.has_error()) { return value.error(); }
+		if (value.front() == ']' || value.front() == '}') { return json_error::invalid_document; }
+		++ret;
+		if constexpr (std::is_same_v<std::invoke_result_t<F, std::string_view, json_value>, bool>) {
+			if (!f(key, value)) { return ret; }
+		} else {
+			f(key, value);
+		}
+		auto const next = value.skip();
+		if (next >= doc.tokens()) { return json_error::invalid_document; }
+		char const c = doc.at(next);
+		if (c == '}') { return ret; }
+		if (c != ',') { return json_error::invalid_document; }
+		tok = next + 1;
+	}
+}
+
+inline kt::result<std::size_t, json_error> json_value::count_elements() const {
+	return for_each_element([](json_value) {});
+}
+} // namespace kt
@@ -0,0 +1,205 @@
+// KT header-only library
+// Requirements: C++17
+
+#pragma once
+#include "result.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+namespace kt {
+///
+/// \brief Lookup failure (key not present)
+///
+struct miss {};
+
+///
+/// \brief Customization point for multi_find; specialize for other (eg open-addressing) maps with:
+/// 	- using key_type / mapped_type
+/// 	- static std::size_t hash(Map const&, key_type const&)
+/// 	- static void prefetch(Map const&, std::size_t hash) : touch the probe start (a hint, may be a no-op)
+/// 	- static mapped_type const* find(Map const&, key_type const&, std::size_t hash)
+/// Prefetch only pays off when the probe address is computable from the hash without loads, ie for open addressing
+/// (see flat_table); node-based maps (std::unordered_map) get a plain adapter without prefetch
+/// Note: multi_find over a std::unordered_map is a plain loop of find() calls and gives no speedup; switch the map to
+/// flat_table to benefit from batching
+///
+template <typename Map>
+struct lookup_adapter;
+
+///
+/// \brief Look up count keys: hash all, prefetch all probe starts, then probe; writes one result per key into out
+/// Returns number of hits
+///
+template <typename Map, typename Key>
+std::size_t multi_find(Map const& map, Key const* keys, std::size_t count,
+					   kt::result<typename lookup_adapter<Map>::mapped_type const*, miss>* out) noexcept(noexcept(lookup_adapter<Map>::hash(map, *keys)) && noexcept(lookup_adapter<Map>::prefetch(map, 0)) &&
+													 noexcept(lookup_adapter<Map>::find(map, *keys, 0)));
+
+///
+/// \brief Open-addressing (linear probing) hash table of K -> V, kept at most 7/8 full
+/// Slot address is a pure function of the hash, so multi_find can prefetch it before probing
+/// K and V must be default constructible
+///
+template <typename K, typename V, typename Hash = std::hash<K>>
+class flat_table {
+  public:
+	using key_type = K;
+	using mapped_type = V;
+
+	explicit flat_table(std::size_t capacity = 0, Hash hasher = {});
+
+	///
+	/// \brief Insert or overwrite; returns true if key was not present
+	///
+	bool insert_or_assign(K key, V value);
+	V const* find(K const& key) const { return find(key, hash(key)); }
+	V const* find(K const& key, std::size_t hash) const;
+
+	std::size_t hash(K const& key) const { return static_cast<std::size_t>(m_hasher(key)); }
+	///
+	/// \brief Address of the first slot probed for hash (pure arithmetic, no loads from the table)
+	///
+	void const* probe_start(std::size_t hash) const noexcept { return m_slots.data() + index(hash); }
+
+	std::size_t size() const noexcept { return m_size; }
+	std::size_t capacity() const noexcept { return m_slots.size(); }
+
+  private:
+	struct slot {
+		K key{};
+		V value{};
+		bool used{};
+	};
+
+	// golden-ratio multiply-shift: top bits of the product, so identity hashes still spread
+	std::size_t index(std::size_t hash) const noexcept { return static_cast<std::size_t>((std::uint64_t(hash) * 0x9E3779B97F4A7C15ULL) >> m_shift); }
+	void rehash(std::size_t capacity);
+
+	std::vector<slot> m_slots;
+	std::size_t m_mask{};
+	unsigned m_shift{};
+	std::size_t m_size{};
+	Hash m_hasher;
+};
+
+namespace detail {
+inline void prefetch(void const* ptr) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+	__builtin_prefetch(ptr);
+#elif defined(_MSC_VER)
+	_mm_prefetch(static_cast<char const*>(ptr), _MM_HINT_T0);
+#else
+	(void)ptr;
+#endif
+}
+} // namespace detail
+
+template <typename K, typename V, typename Hash>
+struct lookup_adapter<flat_table<K, V, Hash>> {
+	using map_type = flat_table<K, V, Hash>;
+	using key_type = K;
+	using mapped_type = V;
+
+	static std::size_t hash(map_type const& map, K const& key) { return map.hash(key); }
+	static void prefetch(map_type const& map, std::size_t hash) noexcept { detail::prefetch(map.probe_start(hash)); }
+	static V const* find(map_type const& map, K const& key, std::size_t hash) { return map.find(key, hash); }
+};
+
+///
+/// \brief Fallback for std::unordered_map: buckets hold node pointers, so any prefetch would itself need two dependent
+/// loads, and find() cannot take a precomputed hash; lookups are simply forwarded (no batching benefit)
+///
+template <typename K, typename V, typename H, typename Eq, typename A>
+struct lookup_adapter<std::unordered_map<K, V, H, Eq, A>> {
+	using map_type = std::unordered_map<K, V, H, Eq, A>;
+	using key_type = K;
+	using mapped_type = V;
+
+	static std::size_t hash(map_type const&, K const&) noexcept { return 0; }
+	static void prefetch(map_type const&, std::size_t) noexcept {}
+
+	static V const* find(map_type const& map, K const& key, std::size_t /*hash*/) {
+		auto const it = map.find(key);
+		return it == map.end() ? nullptr : &it->second;
+	}
+};
+
+template <typename K, typename V, typename Hash>
+flat_table<K, V, Hash>::flat_table(std::size_t capacity, Hash hasher) : m_hasher(std::move(hasher)) {
+	std::size_t cap = 8;
+	while (cap * 7 < capacity * 8) { cap *= 2; }
+	rehash(cap);
+}
+
+template <typename K, typename V, typename Hash>
+bool flat_table<K, V, Hash>::insert_or_assign(K key, V value) {
+	if ((m_size + 1) * 8 > m_slots.size() * 7) { rehash(m_slots.size() * 2); }
+	for (std::size_t i = index(hash(key));; i = (i + 1) & m_mask) {
+		slot& s = m_slots[i];
+		if (!s.used) {
+			s = {std::move(key), std::move(value), true};
+			++m_size;
+			return true;
+		}
+		if (s.key == key) {
+			s.value = std::move(value);
+			return false;
+		}
+	}
+}
+
+template <typename K, typename V, typename Hash>
+V const* flat_table<K, V, Hash>::find(K const& key, std::size_t hash) const {
+	for (std::size_t i = index(hash);; i = (i + 1) & m_mask) {
+		slot const& s = m_slots[i];
+		if (!s.used) { return nullptr; }
+		if (s.key == key) { return &s.value; }
+	}
+}
+
+template <typename K, typename V, typename Hash>
+void flat_table<K, V, Hash>::rehash(std::size_t capacity) {
+	std::vector<slot> old(capacity);
+	std::swap(old, m_slots);
+	m_mask = capacity - 1;
+	m_shift = 64;
+	for (std::size_t cap = capacity; cap > 1; cap /= 2) { --m_shift; }
+	m_size = 0;
+	for (auto& s : old) {
+		if (s.used) { insert_or_assign(std::move(s.key), std::move(s.value)); }
+	}
+}
+
+template <typename Map, typename Key>
+std::size_t multi_find(Map const& map, Key const* keys, std::size_t count,
+					   kt::result<typename lookup_adapter<Map>::mapped_type const*, miss>* out) noexcept(noexcept(lookup_adapter<Map>::hash(map, *keys)) && noexcept(lookup_adapter<Map>::prefetch(map, 0)) &&
+													 noexcept(lookup_adapter<Map>::find(map, *keys, 0))) {
+	using adapter = lookup_adapter<Map>;
+	constexpr std::size_t group = 16;
+	std::size_t hashes[group];
+	std::size_t ret{};
+	for (std::size_t base = 0; base < count; base += group) {
+		std::size_t const n = count - base < group ? count - base : group;
+		for (std::size_t i = 0; i < n; ++i) { hashes[i] = adapter::hash(map, keys[base + i]); }
+		for (std::size_t i = 0; i < n; ++i) { adapter::prefetch(map, hashes[i]); }
+		for (std::size_t i = 0; i < n; ++i) {
+			auto const* found = adapter::find(map, keys[base + i], hashes[i]);
+			if (found) {
+				out[base + i] = found;
+				++ret;
+			} else {
+				out[base + i] = miss{};
+			}
+		}
+	}
+	return ret;
+}
+} // namespace kt
@@ -0,0 +1,295 @@
+// KT header-only library
+// Requirements: C++17, POSIX (mmap); empty otherwise
+
+#pragma once
+#if __has_include(<sys/mman.h>) && __has_include(<unistd.h>)
+#include "crc32c.hpp"
+#include "result.hpp"
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fcntl.h>
+#include <functional>
+#include <optional>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <type_traits>
+#include <unistd.h>
+#include <utility>
+
+#define KT_PERSISTENT_MEMO_AVAILABLE
+
+namespace kt {
+///
+/// \brief Failure to open a persistent memo file: kind and errno (for io)
+/// 	- version_mismatch / checksum_mismatch / bad_layout : only reported with memo_open::fail_invalid
+///
+struct memo_error {
+	enum class kind { unknown, io, version_mismatch, checksum_mismatch, bad_layout };
+
+	int code{};
+	kind type{};
+};
+
+///
+/// \brief What to do with an existing file that does not validate
+///
+enum class memo_open { reset_invalid, fail_invalid };
+
+///
+/// \brief Memo of kt::result<V, E> outcomes keyed by K, in an mmap'd open-addressing table that survives restarts
+/// K, V, E must be trivially copyable and Hash must be stable across processes
+/// The file carries a layout version, the caller's schema version, a type fingerprint and a CRC-32C of the table,
+/// written by flush() (and the destructor); a file that was not flushed after its last store fails validation
+///
+template <typename K, typename V, typename E, typename Hash = std::hash<K>>
+class persistent_memo {
+	static_assert(std::is_trivially_copyable_v<K> && std::is_trivially_copyable_v<V> && std::is_trivially_copyable_v<E>,
+				  "K, V, E must be trivially copyable");
+
+  public:
+	using outcome_t = kt::result<V, E>;
+
+	static constexpr std::uint32_t layout_version = 1;
+
+	///
+	/// \brief Open (or create) path with room for capacity entries (rounded up to a power of two)
+	/// Returns the memo warm if the file validates, else empty (or an error, with fail_invalid)
+	///
+	static kt::result<persistent_memo, memo_error> open(char const* path, std::size_t capacity, std::uint32_t schema_version = 0,
+														memo_open mode = memo_open::reset_invalid);
+
+	persistent_memo(persistent_memo&& rhs) noexcept { swap(rhs); }
+	persistent_memo& operator=(persistent_memo&& rhs) noexcept {
+		if (&rhs != this) {
+			close();
+			swap(rhs);
+		}
+		return *this;
+	}
+	~persistent_memo() { close(); }
+
+	///
+	/// \brief Cached outcome for key, if any
+	///
+	std::optional<outcome_t> find(K const& key) const;
+	///
+	/// \brief Record outcome for key (replacing any previous one); false if the table is full
+	///
+	bool store(K const& key, outcome_t const& outcome);
+	///
+	/// \brief Cached outcome for key, else compute(key) (recorded if there is room)
+	///
+	template <typename F>
+	outcome_t get_or_compute(K const& key, F&& compute);
+
+	///
+	/// \brief Write the checksum and sync the mapping to disk
+	///
+	bool flush();
+
+	///
+	/// \brief True if entries were loaded from an existing file
+	///
+	bool warm() const noexcept { return m_warm; }
+	std::size_t size() const noexcept { return m_header ? static_cast<std::size_t>(m_header->count) : 0; }
+	std::size_t capacity() const noexcept { return m_capacity; }
+
+  private:
+	struct header {
+		char magic[8];
+		std::uint32_t layout;
+		std::uint32_t schema;
+		std::uint64_t fingerprint;
+		std::uint64_t capacity;
+		std::uint64_t count;
+		std::uint32_t checksum;
+		std::uint32_t dirty;
+	};
+
+	enum : std::uint8_t { slot_empty, slot_value, slot_error };
+
+	static constexpr std::size_t payload_size = sizeof(V) > sizeof(E) ? sizeof(V) : sizeof(E);
+	static constexpr std::size_t payload_align = alignof(V) > alignof(E) ? alignof(V) : alignof(E);
+
+	struct slot {
+		K key;
+		alignas(payload_align) unsigned char payload[payload_size];
+		std::uint8_t state;
+	};
+
+	static constexpr std::size_t header_size = (sizeof(header) + alignof(slot) - 1) / alignof(slot) * alignof(slot);
+	static constexpr char magic[8] = {'k', 't', 'm', 'e', 'm', 'o', '\0', '\0'};
+
+	persistent_memo() = default;
+
+	static constexpr std::uint64_t fingerprint() noexcept {
+		return std::uint64_t(sizeof(K)) | std::uint64_t(sizeof(V)) << 16 | std::uint64_t(sizeof(E)) << 32 | std::uint64_t(sizeof(slot)) << 48;
+	}
+	static std::size_t mapped_size(std::size_t capacity) noexcept { return header_size + capacity * sizeof(slot); }
+
+	std::uint32_t table_checksum() const noexcept { return crc32c(m_slots, m_capacity * sizeof(slot)); }
+	std::optional<memo_error::kind> validate(std::uint32_t schema) const noexcept;
+	void reset(std::uint32_t schema) noexcept;
+	slot* probe(K const& key) const noexcept;
+	void close() noexcept;
+
+	void swap(persistent_memo& rhs) noexcept {
+		std::swap(m_fd, rhs.m_fd);
+		std::swap(m_map, rhs.m_map);
+		std::swap(m_header, rhs.m_header);
+		std::swap(m_slots, rhs.m_slots);
+		std::swap(m_capacity, rhs.m_capacity);
+		std::swap(m_warm, rhs.m_warm);
+	}
+
+	int m_fd{-1};
+	void* m_map{};
+	header* m_header{};
+	slot* m_slots{};
+	std::size_t m_capacity{};
+	bool m_warm{};
+};
+
+// impl
+
+template <typename K, typename V, typename E, typename Hash>
+kt::result<persistent_memo<K, V, E, Hash>, memo_error> persistent_memo<K, V, E, Hash>::open(char const* path, std::size_t capacity, std::uint32_t schema_version,
+																							  memo_open mode) {
+	using kind = memo_error::kind;
+	std::size_t cap = 8;
+	while (cap < capacity) { cap *= 2; }
+	persistent_memo ret;
+	ret.m_capacity = cap;
+	ret.m_fd = ::open(path, O_RDWR | O_CREAT, 0644);
+	if (ret.m_fd < 0) { return memo_error{errno, kind::io}; }
+	struct stat st {};
+	if (::fstat(ret.m_fd, &st) != 0) { return memo_error{errno, kind::io}; }
+	auto const existing = static_cast<std::size_t>(st.st_size);
+	std::size_t const size = mapped_size(cap);
+	bool const resized = existing != size;
+	if (resized) {
+		if (existing != 0 && mode == memo_open::fail_invalid) { return memo_error{0, kind::bad_layout}; }
+		if (::ftruncate(ret.m_fd, static_cast<off_t>(size)) != 0) { return memo_error{errno, kind::io}; }
+	}
+	ret.m_map = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, ret.m_fd, 0);
+	if (ret.m_map == MAP_FAILED) {
+		ret.m_map = nullptr;
+		return memo_error{errno, kind::io};
+	}
+	ret.m_header = static_cast<header*>(ret.m_map);
+	ret.m_slots = reinterpret_cast<slot*>(static_cast<unsigned char*>(ret.m_map) + header_size);
+	if (resized) {
+		ret.reset(schema_version);
+		return ret;
+	}
+	if (auto const invalid = ret.validate(schema_version)) {
+		if (mode == memo_open::fail_invalid) { return memo_error{0, *invalid}; }
+		ret.reset(schema_version);
+		return ret;
+	}
+	ret.m_warm = true;
+	return ret;
+}
+
+template <typename K, typename V, typename E, typename Hash>
+std::optional<memo_error::kind> persistent_memo<K, V, E, Hash>::validate(std::uint32_t schema) const noexcept {
+	using kind = memo_error::kind;
+	auto const& h = *m_header;
+	if (std::memcmp(h.magic, magic, sizeof(magic)) != 0 || h.fingerprint != fingerprint() || h.capacity != m_capacity) { return kind::bad_layout; }
+	if (h.layout != layout_version || h.schema != schema) { return kind::version_mismatch; }
+	if (h.dirty != 0 || h.count > m_capacity || h.checksum != table_checksum()) { return kind::checksum_mismatch; }
+	return std::nullopt;
+}
+
+template <typename K, typename V, typename E, typename Hash>
+void persistent_memo<K, V, E, Hash>::reset(std::uint32_t schema) noexcept {
+	std::memset(m_map, 0, mapped_size(m_capacity));
+	auto& h = *m_header;
+	std::memcpy(h.magic, magic, sizeof(magic));
+	h.layout = layout_version;
+	h.schema = schema;
+	h.fingerprint = fingerprint();
+	h.capacity = m_capacity;
+	h.count = 0;
+	h.checksum = table_checksum();
+	h.dirty = 0;
+	m_warm = false;
+}
+
+template <typename K, typename V, typename E, typename Hash>
+auto persistent_memo<K, V, E, Hash>::probe(K const& key) const noexcept -> slot* {
+	std::size_t const mask = m_capacity - 1;
+	for (std::size_t i = static_cast<std::size_t>(Hash{}(key)) & mask;; i = (i + 1) & mask) {
+		slot& s = m_slots[i];
+		if (s.state == slot_empty || s.key == key) { return &s; }
+	}
+}
+
+template <typename K, typename V, typename E, typename Hash>
+auto persistent_memo<K, V, E, Hash>::find(K const& key) const -> std::optional<outcome_t> {
+	slot const& s = *probe(key);
+	if (s.state == slot_value) {
+		V value;
+		std::memcpy(&value, s.payload, sizeof(V));
+		return outcome_t(value);
+	}
+	if (s.state == slot_error) {
+		E error;
+		std::memcpy(&error, s.payload, sizeof(E));
+		return outcome_t(error);
+	}
+	return std::nullopt;
+}
+
+template <typename K, typename V, typename E, typename Hash>
+bool persistent_memo<K, V, E, Hash>::store(K const& key, outcome_t const& outcome) {
+	slot& s = *probe(key);
+	if (s.state == slot_empty) {
+		// keep a quarter of the table free so probes stay short and always terminate
+		if ((m_header->count + 1) * 4 > m_capacity * 3) { return false; }
+		++m_header->count;
+		s.key = key;
+	}
+	m_header->dirty = 1;
+	if (outcome.has_value()) {
+		std::memcpy(s.payload, &outcome.value(), sizeof(V));
+		s.state = slot_value;
+	} else {
+		E const error = outcome.error();
+		std::memcpy(s.payload, &error, sizeof(E));
+		s.state = slot_error;
+	}
+	return true;
+}
+
+template <typename K, typename V, typename E, typename Hash>
+template <typename F>
+auto persistent_memo<K, V, E, Hash>::get_or_compute(K const& key, F&& compute) -> outcome_t {
+	if (auto cached = find(key)) { return std::move(*cached); }
+	outcome_t ret = compute(key);
+	store(key, ret);
+	return ret;
+}
+
+template <typename K, typename V, typename E, typename Hash>
+bool persistent_memo<K, V, E, Hash>::flush() {
+	if (!m_header) { return false; }
+	m_header->checksum = table_checksum();
+	m_header->dirty = 0;
+	return ::msync(m_map, mapped_size(m_capacity), MS_SYNC) == 0;
+}
+
+template <typename K, typename V, typename E, typename Hash>
+void persistent_memo<K, V, E, Hash>::close() noexcept {
+	if (m_header && m_header->dirty) { flush(); }
+	if (m_map) { ::munmap(m_map, mapped_size(m_capacity)); }
+	if (m_fd >= 0) { ::close(m_fd); }
+	m_fd = -1;
+	m_map = nullptr;
+	m_header = nullptr;
+	m_slots = nullptr;
+}
+} // namespace kt
+#endif
@@ -1,5 +1,5 @@
 // KT header-only library
-// Requirements: C++17
+// Requirements: C++17 (constraints use concepts when available)
 
 #pragma once
 #include <cassert>
@@ -7,6 +7,13 @@
 #include <type_traits>
 #include <variant>
 
+#if defined(KT_RESULT_EXTERN_COMMON) || defined(KT_RESULT_INSTANTIATE_COMMON)
+// only needed for the common specializations below; kept conditional so the default mode stays <string>-free
+#include <cstddef>
+#include <string>
+#include <system_error>
+#endif
+
 namespace kt {
 namespace detail {
 template <typename T, typename E>
@@ -29,6 +36,25 @@ class result;
 ///
 constexpr auto null_result = nullptr;
 
+namespace detail {
+template <typename T>
+struct is_result : std::false_type {};
+template <typename T, typename E>
+struct is_result<result<T, E>> : std::true_type {};
+
+///
+/// \brief True if U is T, or implicitly converts to T but not to E (unambiguous construction of T)
+///
+template <typename U, typename T, typename E, typename D = std::decay_t<U>>
+constexpr bool converts_only_to_v = !std::is_same_v<D, E> && !std::is_same_v<D, std::nullptr_t> && !is_result<D>::value &&
+									(std::is_same_v<D, T> || (std::is_convertible_v<U, T> && !std::is_convertible_v<U, E>));
+
+#if defined(__cpp_concepts)
+template <typename U, typename T, typename E>
+concept converts_only_to = converts_only_to_v<U, T, E>;
+#endif
+} // namespace detail
+
 ///
 /// \brief Models a result (T) or an error (E) value
 /// Note: T cannot be void
@@ -46,21 +72,24 @@ class result {
 	///
 	constexpr result() = default;
 	///
-	/// \brief Constructor for result (success)
-	///
-	constexpr result(T&& t) : m_storage(std::move(t)) {}
-	///
-	/// \brief Constructor for result (success)
-	///
-	constexpr result(T const& t) : m_storage(t) {}
+	/// \brief Constructor for result (success) from T or anything that converts only to T; constructs T in place
+	/// (U defaults to T so braced initializers still work)
 	///
-	/// \brief Constructor for error (failure)
+#if defined(__cpp_concepts)
+	template <detail::converts_only_to<T, E> U = T>
+#else
+	template <typename U = T, std::enable_if_t<detail::converts_only_to_v<U, T, E>, int> = 0>
+#endif
+	constexpr result(U&& u) : m_storage(std::in_place_type<T>, std::forward<U>(u)) {}
 	///
-	constexpr result(E&& e) : m_storage(std::move(e)) {}
+	/// \brief Constructor for error (failure) from E or anything that converts only to E; constructs E in place
 	///
-	/// \brief Constructor for error (failure)
-	///
-	constexpr result(E const& e) : m_storage(e) {}
+#if defined(__cpp_concepts)
+	template <detail::converts_only_to<E, T> U = E>
+#else
+	template <typename U = E, std::enable_if_t<detail::converts_only_to_v<U, E, T>, int> = 0>
+#endif
+	constexpr result(U&& u) : m_storage(std::in_place_type<E>, std::forward<U>(u)) {}
 	///
 	/// \brief Constructor for implicit failure
 	///
@@ -77,7 +106,7 @@ class result {
 	///
 	/// \brief Move result from rvalue this
 	///
-	constexpr T value() const&& { return std::move(m_storage).value(); }
+	constexpr T value() && { return std::move(m_storage).value(); }
 	constexpr T const& value_or(T const& fallback) const { return has_value() ? value() : fallback; }
 	constexpr E const& error() const { return m_storage.error(); }
 
@@ -164,13 +193,15 @@ class result<T, void> {
 	///
 	constexpr result() = default;
 	///
-	/// \brief Constructor for result (success)
-	///
-	constexpr result(T&& t) : m_storage(std::move(t)) {}
-	///
-	/// \brief Constructor for result (success)
+	/// \brief Constructor for result (success) from T or anything that converts to T; constructs T in place
+	/// (U defaults to T so braced initializers still work)
 	///
-	constexpr result(T const& t) : m_storage(t) {}
+#if defined(__cpp_concepts)
+	template <detail::converts_only_to<T, void> U = T>
+#else
+	template <typename U = T, std::enable_if_t<detail::converts_only_to_v<U, T, void>, int> = 0>
+#endif
+	constexpr result(U&& u) : m_storage(std::in_place_type<T>, std::forward<U>(u)) {}
 	///
 	/// \brief Constructor for implicit failure
 	///
@@ -206,10 +237,8 @@ struct result_storage_t {
 	std::variant<T, E> val;
 
 	constexpr result_storage_t() : val(E{}) {}
-	constexpr result_storage_t(T&& t) : val(std::move(t)) {}
-	constexpr result_storage_t(T const& t) : val(t) {}
-	constexpr result_storage_t(E&& e) : val(std::move(e)) {}
-	constexpr result_storage_t(E const& e) : val(e) {}
+	template <typename V, typename U>
+	constexpr result_storage_t(std::in_place_type_t<V> tag, U&& u) : val(tag, std::forward<U>(u)) {}
 	constexpr bool has_value() const noexcept { return std::holds_alternative<T>(val); }
 	constexpr T const& value() const& {
 		assert(has_value());
@@ -231,6 +260,12 @@ struct result_storage_t<T, void> {
 	constexpr result_storage_t() = default;
 	constexpr result_storage_t(T&& t) : val(std::move(t)) {}
 	constexpr result_storage_t(T const& t) : val(t) {}
+	template <typename U>
+	constexpr result_storage_t(std::in_place_type_t<T>, U&& u) : val(std::in_place, std::forward<U>(u)) {}
+	template <typename U>
+	constexpr void emplace(U&& u) {
+		val.emplace(std::forward<U>(u));
+	}
 	constexpr bool has_value() const noexcept { return val.has_value(); }
 	constexpr T const& value() const& {
 		assert(has_value());
@@ -246,9 +281,44 @@ struct result_storage_t<bool, void> {
 	bool val;
 
 	constexpr result_storage_t() : val(false) {}
-	constexpr result_storage_t(bool val) : val(val) {}
+	template <typename U>
+	constexpr result_storage_t(std::in_place_type_t<bool>, U&& u) : val(std::forward<U>(u)) {}
 	constexpr bool has_value() const noexcept { return val; }
-	constexpr bool value() const { return val; }
+	constexpr bool const& value() const { return val; }
 };
 } // namespace detail
 } // namespace kt
+
+///
+/// \brief Declare an explicit instantiation of kt::result<T, E> (suppresses implicit instantiation in this TU)
+/// Note: pair with exactly one KT_RESULT_INSTANTIATE_TEMPLATE(T, E) in the program
+///
+#define KT_RESULT_EXTERN_TEMPLATE(T, E) extern template class ::kt::result<T, E>
+///
+/// \brief Define an explicit instantiation of kt::result<T, E>
+///
+#define KT_RESULT_INSTANTIATE_TEMPLATE(T, E) template class ::kt::result<T, E>
+
+///
+/// \brief Library mode for common specializations
+/// 	- KT_RESULT_EXTERN_COMMON : declare common specializations as extern in every TU
+/// 	- KT_RESULT_INSTANTIATE_COMMON : define them (in exactly one TU)
+/// Note: only pays off in unoptimized (-O0 / debug) builds; optimizing compilers still instantiate the inline members
+/// for inlining, so with -O2 the mode makes builds slightly slower and objects larger
+///
+#if defined(KT_RESULT_EXTERN_COMMON) || defined(KT_RESULT_INSTANTIATE_COMMON)
+#if defined(KT_RESULT_INSTANTIATE_COMMON)
+#define KT_RESULT_COMMON_TEMPLATE KT_RESULT_INSTANTIATE_TEMPLATE
+#else
+#define KT_RESULT_COMMON_TEMPLATE KT_RESULT_EXTERN_TEMPLATE
+#endif
+
+KT_RESULT_COMMON_TEMPLATE(int, void);
+KT_RESULT_COMMON_TEMPLATE(int, int);
+KT_RESULT_COMMON_TEMPLATE(int, std::errc);
+KT_RESULT_COMMON_TEMPLATE(std::size_t, std::errc);
+KT_RESULT_COMMON_TEMPLATE(std::string, void);
+KT_RESULT_COMMON_TEMPLATE(std::string, std::errc);
+
+#undef KT_RESULT_COMMON_TEMPLATE
+#endif
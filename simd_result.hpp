@@ -0,0 +1,253 @@
+// KT header-only library
+// Requirements: C++17
+
+#pragma once
+#include "result.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace kt {
+///
+/// \brief Outcome of one lane of a fallible kernel (plain aggregate, unlike kt::result, so loops over it vectorize)
+///
+template <typename T, typename E>
+struct simd_lane {
+	T value{};
+	E error{};
+	bool ok{};
+};
+
+template <typename T, typename E>
+constexpr simd_lane<T, E> lane_ok(T value) noexcept {
+	return {value, E{}, true};
+}
+
+template <typename T, typename E>
+constexpr simd_lane<T, E> lane_error(E error) noexcept {
+	return {T{}, error, false};
+}
+
+///
+/// \brief Branch-free lane: ok with value if condition holds, else error (value is kept either way)
+/// Prefer this over `cond ? lane_ok(..) : lane_error(..)` inside kernels, which compilers tend to lower to branches
+///
+template <typename T, typename E>
+constexpr simd_lane<T, E> lane_if(bool condition, T value, E error) noexcept {
+	return {value, condition ? E{} : error, condition};
+}
+
+///
+/// \brief N values of T, each paired with a lane state (ok / error E), stored as parallel arrays
+/// Combinators run every lane unconditionally and merge states with selects: callables must be total over T
+/// (failed lanes carry T{} or a previous lane value) and should be free of side effects
+///
+template <typename T, std::size_t N, typename E>
+class simd_result {
+	static_assert(N > 0, "N must be positive");
+	static_assert(std::is_trivially_copyable_v<T> && std::is_trivially_copyable_v<E>, "T and E must be trivially copyable");
+
+  public:
+	using type = T;
+	using err_t = E;
+	static constexpr std::size_t size = N;
+
+	///
+	/// \brief Default constructor (all lanes failed with E{})
+	///
+	constexpr simd_result() = default;
+
+	///
+	/// \brief All lanes ok with values [in, in + N)
+	///
+	static simd_result load(T const* in) noexcept;
+	///
+	/// \brief All lanes ok with value
+	///
+	static simd_result broadcast(T value) noexcept;
+	///
+	/// \brief Gather lanes from [in, in + N)
+	///
+	static simd_result from_results(kt::result<T, E> const* in);
+	///
+	/// \brief Scatter lanes into [out, out + N)
+	///
+	void to_results(kt::result<T, E>* out) const;
+
+	constexpr bool ok(std::size_t lane) const noexcept { return m_ok[lane] != 0; }
+	constexpr T const& value(std::size_t lane) const noexcept { return m_values[lane]; }
+	constexpr E const& error(std::size_t lane) const noexcept { return m_errors[lane]; }
+	void set(std::size_t lane, T value) noexcept;
+	void set_error(std::size_t lane, E error) noexcept;
+
+	std::size_t count_ok() const noexcept;
+	bool all_ok() const noexcept { return count_ok() == N; }
+	bool any_ok() const noexcept { return count_ok() > 0; }
+	///
+	/// \brief Write each lane's value (or fallback for failed lanes) into [out, out + N)
+	///
+	void store_or(T* out, T fallback) const noexcept;
+
+	///
+	/// \brief Map values through f (T -> U) in every lane; lane states are unchanged
+	///
+	template <typename F>
+	auto transform(F&& f) const -> simd_result<std::decay_t<std::invoke_result_t<F&, T const&>>, N, E>;
+	///
+	/// \brief Chain a fallible step f (T -> simd_lane<U, E>); ok lanes take f's state, failed lanes keep their error
+	///
+	template <typename F>
+	auto and_then(F&& f) const -> simd_result<decltype(std::declval<std::invoke_result_t<F&, T const&>>().value), N, E>;
+	///
+	/// \brief Per lane: this lane if ok, else fallback's
+	///
+	simd_result select(simd_result const& fallback) const noexcept;
+	///
+	/// \brief Fold ok lanes with op, substituting identity for failed ones
+	/// op must be associative and commutative (lanes are combined as a tree of halves)
+	///
+	template <typename Op>
+	T reduce_ok(T identity, Op&& op) const;
+
+  private:
+	T m_values[N]{};
+	E m_errors[N]{};
+	std::uint8_t m_ok[N]{};
+
+	template <typename U, std::size_t M, typename F>
+	friend class simd_result;
+};
+
+// impl
+
+template <typename T, std::size_t N, typename E>
+simd_result<T, N, E> simd_result<T, N, E>::load(T const* in) noexcept {
+	simd_result ret;
+	for (std::size_t i = 0; i < N; ++i) {
+		ret.m_values[i] = in[i];
+		ret.m_ok[i] = 1;
+	}
+	return ret;
+}
+
+template <typename T, std::size_t N, typename E>
+simd_result<T, N, E> simd_result<T, N, E>::broadcast(T value) noexcept {
+	simd_result ret;
+	for (std::size_t i = 0; i < N; ++i) {
+		ret.m_values[i] = value;
+		ret.m_ok[i] = 1;
+	}
+	return ret;
+}
+
+template <typename T, std::size_t N, typename E>
+simd_result<T, N, E> simd_result<T, N, E>::from_results(kt::result<T, E> const* in) {
+	simd_result ret;
+	for (std::size_t i = 0; i < N; ++i) {
+		if (in[i].has_value()) {
+			ret.set(i, in[i].value());
+		} else {
+			ret.set_error(i, in[i].error());
+		}
+	}
+	return ret;
+}
+
+template <typename T, std::size_t N, typename E>
+void simd_result<T, N, E>::to_results(kt::result<T, E>* out) const {
+	for (std::size_t i = 0; i < N; ++i) {
+		if constexpr (std::is_same_v<T, E>) {
+			// result<T, T> cannot tell a value from an error by type
+			if (m_ok[i]) {
+				out[i].set_result(m_values[i]);
+			} else {
+				out[i].set_error(m_errors[i]);
+			}
+		} else if (m_ok[i]) {
+			out[i] = m_values[i];
+		} else {
+			out[i] = m_errors[i];
+		}
+	}
+}
+
+template <typename T, std::size_t N, typename E>
+void simd_result<T, N, E>::set(std::size_t lane, T value) noexcept {
+	m_values[lane] = value;
+	m_errors[lane] = E{};
+	m_ok[lane] = 1;
+}
+
+template <typename T, std::size_t N, typename E>
+void simd_result<T, N, E>::set_error(std::size_t lane, E error) noexcept {
+	m_values[lane] = T{};
+	m_errors[lane] = error;
+	m_ok[lane] = 0;
+}
+
+template <typename T, std::size_t N, typename E>
+std::size_t simd_result<T, N, E>::count_ok() const noexcept {
+	std::size_t ret{};
+	for (std::size_t i = 0; i < N; ++i) { ret += m_ok[i]; }
+	return ret;
+}
+
+template <typename T, std::size_t N, typename E>
+void simd_result<T, N, E>::store_or(T* out, T fallback) const noexcept {
+	for (std::size_t i = 0; i < N; ++i) { out[i] = m_ok[i] ? m_values[i] : fallback; }
+}
+
+template <typename T, std::size_t N, typename E>
+template <typename F>
+auto simd_result<T, N, E>::transform(F&& f) const -> simd_result<std::decay_t<std::invoke_result_t<F&, T const&>>, N, E> {
+	simd_result<std::decay_t<std::invoke_result_t<F&, T const&>>, N, E> ret;
+	for (std::size_t i = 0; i < N; ++i) {
+		ret.m_values[i] = f(m_values[i]);
+		ret.m_errors[i] = m_errors[i];
+		ret.m_ok[i] = m_ok[i];
+	}
+	return ret;
+}
+
+template <typename T, std::size_t N, typename E>
+template <typename F>
+auto simd_result<T, N, E>::and_then(F&& f) const -> simd_result<decltype(std::declval<std::invoke_result_t<F&, T const&>>().value), N, E> {
+	using lane_t = std::invoke_result_t<F&, T const&>;
+	static_assert(std::is_same_v<std::decay_t<decltype(std::declval<lane_t>().error)>, E>, "f must return simd_lane<U, E>");
+	simd_result<decltype(std::declval<lane_t>().value), N, E> ret;
+	for (std::size_t i = 0; i < N; ++i) {
+		auto const lane = f(m_values[i]);
+		bool const was_ok = m_ok[i] != 0;
+		ret.m_values[i] = lane.value;
+		ret.m_errors[i] = was_ok ? lane.error : m_errors[i];
+		ret.m_ok[i] = static_cast<std::uint8_t>(was_ok & lane.ok);
+	}
+	return ret;
+}
+
+template <typename T, std::size_t N, typename E>
+simd_result<T, N, E> simd_result<T, N, E>::select(simd_result const& fallback) const noexcept {
+	simd_result ret;
+	for (std::size_t i = 0; i < N; ++i) {
+		bool const mine = m_ok[i] != 0;
+		ret.m_values[i] = mine ? m_values[i] : fallback.m_values[i];
+		ret.m_errors[i] = mine ? m_errors[i] : fallback.m_errors[i];
+		ret.m_ok[i] = mine ? m_ok[i] : fallback.m_ok[i];
+	}
+	return ret;
+}
+
+template <typename T, std::size_t N, typename E>
+template <typename Op>
+T simd_result<T, N, E>::reduce_ok(T identity, Op&& op) const {
+	T masked[N];
+	for (std::size_t i = 0; i < N; ++i) { masked[i] = m_ok[i] ? m_values[i] : identity; }
+	std::size_t width = N;
+	while (width > 1) {
+		std::size_t const half = width / 2;
+		for (std::size_t i = 0; i < half; ++i) { masked[i] = op(masked[i], masked[width - half + i]); }
+		width -= half;
+	}
+	return masked[0];
+}
+} // namespace kt
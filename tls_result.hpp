@@ -0,0 +1,113 @@
+// KT header-only library
+// Requirements: C++17
+
+#pragma once
+#include "result.hpp"
+#include <optional>
+#include <utility>
+#include <variant>
+
+namespace kt {
+namespace detail {
+///
+/// \brief Per-thread, per-E pending error
+///
+template <typename E>
+std::optional<E>& tls_error_slot() noexcept {
+	thread_local std::optional<E> slot;
+	return slot;
+}
+
+struct tls_implicit_failure {};
+struct tls_parked_error {};
+} // namespace detail
+
+///
+/// \brief Models a result (T) or an error (E) value, storing only T and a state byte (value / parked error / implicit failure)
+/// An explicit error payload is parked in a thread-local slot (one per E) and moved out by error(); implicit failures
+/// (default / nullptr construction) never touch the slot and report E{}
+/// Note: error() must be called on the thread that produced the failure, before that thread fails with another E
+///
+template <typename T, typename E>
+class tls_result {
+	static_assert(!std::is_same_v<T, void>, "T = void is not supported");
+	static_assert(!std::is_same_v<T, E>, "T = E is not supported");
+
+  public:
+	using type = T;
+	using err_t = E;
+
+	///
+	/// \brief Default constructor (implicit failure, error() returns E{})
+	///
+	constexpr tls_result() noexcept = default;
+	///
+	/// \brief Constructor for result (success)
+	///
+	constexpr tls_result(T&& t) : m_storage(std::in_place_index<value_index>, std::move(t)) {}
+	///
+	/// \brief Constructor for result (success)
+	///
+	constexpr tls_result(T const& t) : m_storage(std::in_place_index<value_index>, t) {}
+	///
+	/// \brief Constructor for error (failure); replaces any pending error of this thread
+	///
+	tls_result(E&& e) : m_storage(detail::tls_parked_error{}) { detail::tls_error_slot<E>() = std::move(e); }
+	///
+	/// \brief Constructor for error (failure); replaces any pending error of this thread
+	///
+	tls_result(E const& e) : m_storage(detail::tls_parked_error{}) { detail::tls_error_slot<E>() = e; }
+	///
+	/// \brief Constructor for implicit failure (error() returns E{})
+	///
+	constexpr tls_result(std::nullptr_t) noexcept {}
+
+	constexpr explicit operator bool() const noexcept { return has_value(); }
+	constexpr bool has_value() const noexcept { return m_storage.index() == value_index; }
+	constexpr bool has_error() const noexcept { return !has_value(); }
+
+	///
+	/// \brief Obtain const lvalue ref to result from non-rvalue this
+	///
+	constexpr T const& value() const& {
+		assert(has_value());
+		return *std::get_if<value_index>(&m_storage);
+	}
+	///
+	/// \brief Move result from rvalue this
+	///
+	constexpr T value() && {
+		assert(has_value());
+		return std::move(*std::get_if<value_index>(&m_storage));
+	}
+	constexpr T const& value_or(T const& fallback) const { return has_value() ? value() : fallback; }
+	///
+	/// \brief Move parked error out of this thread's slot (E{} for implicit failures, or if it was already moved out)
+	///
+	E error() const {
+		assert(has_error());
+		if (!std::holds_alternative<detail::tls_parked_error>(m_storage)) { return E{}; }
+		auto& slot = detail::tls_error_slot<E>();
+		if (!slot) { return E{}; }
+		E ret = std::move(*slot);
+		slot.reset();
+		return ret;
+	}
+
+	constexpr T const& operator*() const { return value(); }
+	constexpr T const* operator->() const { return &value(); }
+
+	///
+	/// \brief Convert to kt::result<T, E> (moves error out of the slot on failure)
+	///
+	kt::result<T, E> to_result() && {
+		if (has_value()) { return std::move(*this).value(); }
+		return error();
+	}
+
+  private:
+	static constexpr std::size_t value_index = 2;
+
+	std::variant<detail::tls_implicit_failure, detail::tls_parked_error, T> m_storage;
+};
+} // namespace kt
@@ -0,0 +1,214 @@
+// KT header-only library
+// Requirements: C++17
+
+#pragma once
+#include "result.hpp"
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define KT_TOKENIZER_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace kt {
+///
+/// \brief Malformed row: kind and byte offset (into the input) where it was detected
+///
+struct tokenize_error {
+	enum class kind { unknown, unterminated_quote, stray_quote };
+
+	kind type{};
+	std::size_t offset{};
+};
+
+///
+/// \brief Delimited format description (CSV, TSV, etc)
+///
+struct delimited_format {
+	char delimiter = ',';
+	char quote = '"';
+	bool quoting = true;
+};
+
+///
+/// \brief Non-owning view of a row's fields (valid until the next call to next_row())
+/// Note: quoted fields exclude the enclosing quotes; doubled quotes within are left intact
+///
+class field_span {
+  public:
+	constexpr field_span() = default;
+	constexpr field_span(std::string_view const* data, std::size_t size) noexcept : m_data(data), m_size(size) {}
+
+	constexpr std::string_view const* begin() const noexcept { return m_data; }
+	constexpr std::string_view const* end() const noexcept { return m_data + m_size; }
+	constexpr std::size_t size() const noexcept { return m_size; }
+	constexpr bool empty() const noexcept { return m_size == 0; }
+	constexpr std::string_view operator[](std::size_t index) const {
+		assert(index < m_size);
+		return m_data[index];
+	}
+
+  private:
+	std::string_view const* m_data{};
+	std::size_t m_size{};
+};
+
+///
+/// \brief Splits delimited text into rows of fields, locating delimiters, quotes and newlines 64 bytes at a time
+/// Malformed rows are reported as errors in place; the following call resumes at the next row
+///
+class delimited_tokenizer {
+  public:
+	explicit delimited_tokenizer(std::string_view text, delimited_format format = {}) : m_text(text), m_format(format) {}
+
+	bool at_end() const noexcept { return m_pos >= m_text.size(); }
+	///
+	/// \brief Number of rows consumed so far
+	///
+	std::size_t rows() const noexcept { return m_rows; }
+
+	///
+	/// \brief Tokenize the next row
+	///
+	kt::result<field_span, tokenize_error> next_row();
+
+  private:
+	std::size_t next_special(std::size_t from);
+	void load_block(std::size_t base);
+	std::size_t skip_row(std::size_t from);
+
+	std::string_view m_text;
+	delimited_format m_format;
+	std::vector<std::string_view> m_fields;
+	std::size_t m_pos{};
+	std::size_t m_rows{};
+	std::size_t m_block_base{};
+	std::uint64_t m_block_mask{};
+	bool m_block_valid{};
+};
+
+namespace detail {
+inline int tokenizer_ctz(std::uint64_t x) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+	return __builtin_ctzll(x);
+#else
+	int ret{};
+	while ((x & 1) == 0) {
+		x >>= 1;
+		++ret;
+	}
+	return ret;
+#endif
+}
+
+#if defined(KT_TOKENIZER_SSE2)
+inline std::uint64_t tokenizer_mask16(char const* ptr, __m128i delim, __m128i quote, __m128i newline) noexcept {
+	auto const v = _mm_loadu_si128(reinterpret_cast<__m128i const*>(ptr));
+	auto const eq = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, delim), _mm_cmpeq_epi8(v, quote)), _mm_cmpeq_epi8(v, newline));
+	return static_cast<std::uint64_t>(static_cast<std::uint32_t>(_mm_movemask_epi8(eq)));
+}
+#endif
+} // namespace detail
+
+inline void delimited_tokenizer::load_block(std::size_t base) {
+	m_block_base = base;
+	m_block_valid = true;
+	m_block_mask = 0;
+	char const quote = m_format.quoting ? m_format.quote : '\n';
+	std::size_t const remain = m_text.size() - base;
+	char const* ptr = m_text.data() + base;
+#if defined(KT_TOKENIZER_SSE2)
+	if (remain >= 64) {
+		auto const d = _mm_set1_epi8(m_format.delimiter);
+		auto const q = _mm_set1_epi8(quote);
+		auto const n = _mm_set1_epi8('\n');
+		m_block_mask = detail::tokenizer_mask16(ptr, d, q, n) | (detail::tokenizer_mask16(ptr + 16, d, q, n) << 16) |
+					   (detail::tokenizer_mask16(ptr + 32, d, q, n) << 32) | (detail::tokenizer_mask16(ptr + 48, d, q, n) << 48);
+		return;
+	}
+#endif
+	std::size_t const count = remain < 64 ? remain : 64;
+	for (std::size_t i = 0; i < count; ++i) {
+		char const c = ptr[i];
+		if (c == m_format.delimiter || c == quote || c == '\n') { m_block_mask |= std::uint64_t(1) << i; }
+	}
+}
+
+inline std::size_t delimited_tokenizer::next_special(std::size_t from) {
+	if (!m_block_valid || from < m_block_base) { load_block(from); }
+	while (from < m_text.size()) {
+		if (from >= m_block_base + 64) { load_block(from); }
+		auto const mask = m_block_mask & (~std::uint64_t(0) << (from - m_block_base));
+		if (mask) { return m_block_base + static_cast<std::size_t>(detail::tokenizer_ctz(mask)); }
+		from = m_block_base + 64;
+	}
+	return m_text.size();
+}
+
+inline std::size_t delimited_tokenizer::skip_row(std::size_t from) {
+	while (from < m_text.size()) {
+		auto const pos = next_special(from);
+		if (pos == m_text.size()) { return pos; }
+		if (m_text[pos] == '\n') { return pos + 1; }
+		from = pos + 1;
+	}
+	return m_text.size();
+}
+
+inline kt::result<field_span, tokenize_error> delimited_tokenizer::next_row() {
+	m_fields.clear();
+	std::size_t const size = m_text.size();
+	std::size_t field_start = m_pos;
+	std::size_t pos = m_pos;
+	auto fail = [&](tokenize_error::kind type, std::size_t offset) {
+		m_pos = skip_row(offset + 1 < size ? offset + 1 : size);
+		++m_rows;
+		return tokenize_error{type, offset};
+	};
+	auto finish = [&](std::size_t field_end, std::size_t next) {
+		if (field_end > field_start && m_text[field_end - 1] == '\r') { --field_end; }
+		m_fields.push_back(m_text.substr(field_start, field_end - field_start));
+		m_pos = next;
+		++m_rows;
+		return field_span(m_fields.data(), m_fields.size());
+	};
+	while (true) {
+		pos = next_special(pos);
+		if (pos == size) { return finish(size, size); }
+		char const c = m_text[pos];
+		if (c == '\n') { return finish(pos, pos + 1); }
+		if (c == m_format.delimiter) {
+			m_fields.push_back(m_text.substr(field_start, pos - field_start));
+			field_start = ++pos;
+			continue;
+		}
+		// opening quote: only valid at the start of a field
+		if (pos != field_start) { return fail(tokenize_error::kind::stray_quote, pos); }
+		std::size_t const open = pos;
+		while (true) {
+			pos = next_special(pos + 1);
+			if (pos == size) { return fail(tokenize_error::kind::unterminated_quote, open); }
+			if (m_text[pos] != m_format.quote) { continue; }
+			if (pos + 1 < size && m_text[pos + 1] == m_format.quote) {
+				++pos;
+				continue;
+			}
+			break;
+		}
+		std::size_t const close = pos++;
+		auto const field = m_text.substr(open + 1, close - open - 1);
+		if (pos < size && m_text[pos] == '\r') { ++pos; }
+		if (pos == size || m_text[pos] == '\n') {
+			m_fields.push_back(field);
+			m_pos = pos == size ? size : pos + 1;
+			++m_rows;
+			return field_span(m_fields.data(), m_fields.size());
+		}
+		if (m_text[pos] != m_format.delimiter) { return fail(tokenize_error::kind::stray_quote, close); }
+		m_fields.push_back(field);
+		field_start = ++pos;
+	}
+}
+} // namespace kt
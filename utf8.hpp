@@ -0,0 +1,348 @@
+// KT header-only library
+// Requirements: C++17
+
+#pragma once
+#include "result.hpp"
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define KT_UTF8_X86_DISPATCH
+#include <immintrin.h>
+#endif
+
+namespace kt {
+///
+/// \brief Invalid input: offset (in input code units) of the offending sequence and its kind
+///
+struct utf8_error {
+	enum class kind { unknown, too_short, too_long, overlong, too_large, surrogate, header_bits, output_too_small };
+
+	std::size_t offset{};
+	kind type{};
+};
+
+namespace utf8 {
+///
+/// \brief Validate UTF-8; returns input size on success
+/// Blocks are checked with SSSE3 / AVX2 (selected at runtime); the error offset is computed only on failure
+///
+kt::result<std::size_t, utf8_error> validate(std::string_view in);
+
+///
+/// \brief Transcode UTF-8 to UTF-16; returns code units written (at most in.size())
+///
+kt::result<std::size_t, utf8_error> to_utf16(std::string_view in, char16_t* out, std::size_t capacity);
+///
+/// \brief Transcode UTF-8 to UTF-32; returns code units written (at most in.size())
+///
+kt::result<std::size_t, utf8_error> to_utf32(std::string_view in, char32_t* out, std::size_t capacity);
+///
+/// \brief Transcode UTF-16 to UTF-8; returns bytes written (at most 3 * in.size())
+///
+kt::result<std::size_t, utf8_error> from_utf16(std::u16string_view in, char* out, std::size_t capacity);
+///
+/// \brief Transcode UTF-32 to UTF-8; returns bytes written (at most 4 * in.size())
+///
+kt::result<std::size_t, utf8_error> from_utf32(std::u32string_view in, char* out, std::size_t capacity);
+} // namespace utf8
+
+namespace detail {
+///
+/// \brief Length of ASCII prefix of [ptr, ptr + size), eight bytes at a time
+///
+inline std::size_t utf8_ascii_prefix(std::uint8_t const* ptr, std::size_t size) noexcept {
+	std::size_t ret{};
+	for (; ret + 8 <= size; ret += 8) {
+		std::uint64_t word;
+		std::memcpy(&word, ptr + ret, sizeof(word));
+		if (word & 0x8080808080808080ULL) { break; }
+	}
+	while (ret < size && ptr[ret] < 0x80) { ++ret; }
+	return ret;
+}
+
+///
+/// \brief Decode one (non-ASCII) sequence at ptr[i]; returns length or error
+///
+inline kt::result<std::size_t, utf8_error> utf8_decode(std::uint8_t const* ptr, std::size_t size, std::size_t i, char32_t& cp) noexcept {
+	using kind = utf8_error::kind;
+	std::uint8_t const b = ptr[i];
+	if (b < 0x80) {
+		cp = b;
+		return std::size_t(1);
+	}
+	if (b < 0xC0) { return utf8_error{i, kind::too_long}; }
+	if (b < 0xC2) { return utf8_error{i, kind::overlong}; }
+	std::size_t const len = b < 0xE0 ? 2 : b < 0xF0 ? 3 : b < 0xF5 ? 4 : 0;
+	if (len == 0) { return utf8_error{i, b < 0xF8 ? kind::too_large : kind::header_bits}; }
+	for (std::size_t j = 1; j < len; ++j) {
+		if (i + j >= size || (ptr[i + j] & 0xC0) != 0x80) { return utf8_error{i, kind::too_short}; }
+	}
+	std::uint8_t const c1 = ptr[i + 1];
+	switch (len) {
+	case 2: cp = char32_t((b & 0x1F) << 6) | (c1 & 0x3F); break;
+	case 3:
+		if (b == 0xE0 && c1 < 0xA0) { return utf8_error{i, kind::overlong}; }
+		if (b == 0xED && c1 >= 0xA0) { return utf8_error{i, kind::surrogate}; }
+		cp = char32_t((b & 0x0F) << 12) | char32_t((c1 & 0x3F) << 6) | (ptr[i + 2] & 0x3F);
+		break;
+	default:
+		if (b == 0xF0 && c1 < 0x90) { return utf8_error{i, kind::overlong}; }
+		if (b == 0xF4 && c1 >= 0x90) { return utf8_error{i, kind::too_large}; }
+		cp = char32_t((b & 0x07) << 18) | char32_t((c1 & 0x3F) << 12) | char32_t((ptr[i + 2] & 0x3F) << 6) | (ptr[i + 3] & 0x3F);
+		break;
+	}
+	return len;
+}
+
+inline kt::result<std::size_t, utf8_error> utf8_validate_scalar(std::uint8_t const* ptr, std::size_t size, std::size_t start) noexcept {
+	std::size_t i = start;
+	while (i < size) {
+		i += utf8_ascii_prefix(ptr + i, size - i);
+		if (i == size) { break; }
+		char32_t cp;
+		auto const len = utf8_decode(ptr, size, i, cp);
+		if (!len) { return len.error(); }
+		i += len.value();
+	}
+	return size;
+}
+
+// Block validation after Keiser & Lemire, "Validating UTF-8 In Less Than One Instruction Per Byte" (2021).
+// Each returns the number of leading bytes (a multiple of the block size) known to be valid up to the
+// first block that contains or completes an error; the scalar path resumes from there for exact offsets.
+#if defined(KT_UTF8_X86_DISPATCH)
+enum : std::uint8_t {
+	utf8_too_short = 1 << 0,
+	utf8_too_long = 1 << 1,
+	utf8_overlong_3 = 1 << 2,
+	utf8_too_large = 1 << 3,
+	utf8_surrogate = 1 << 4,
+	utf8_overlong_2 = 1 << 5,
+	utf8_too_large_1000 = 1 << 6,
+	utf8_overlong_4 = 1 << 6,
+	utf8_two_conts = 1 << 7,
+	utf8_carry = utf8_too_short | utf8_too_long | utf8_two_conts,
+};
+
+#define KT_UTF8_BYTE_1_HIGH                                                                                                                                \
+	char(utf8_too_long), char(utf8_too_long), char(utf8_too_long), char(utf8_too_long), char(utf8_too_long), char(utf8_too_long), char(utf8_too_long),     \
+		char(utf8_too_long), char(utf8_two_conts), char(utf8_two_conts), char(utf8_two_conts), char(utf8_two_conts),                                       \
+		char(utf8_too_short | utf8_overlong_2), char(utf8_too_short), char(utf8_too_short | utf8_overlong_3 | utf8_surrogate),                             \
+		char(utf8_too_short | utf8_too_large | utf8_too_large_1000 | utf8_overlong_4)
+#define KT_UTF8_BYTE_1_LOW                                                                                                                                 \
+	char(utf8_carry | utf8_overlong_3 | utf8_overlong_2 | utf8_overlong_4), char(utf8_carry | utf8_overlong_2), char(utf8_carry), char(utf8_carry),        \
+		char(utf8_carry | utf8_too_large), char(utf8_carry | utf8_too_large | utf8_too_large_1000),                                                        \
+		char(utf8_carry | utf8_too_large | utf8_too_large_1000), char(utf8_carry | utf8_too_large | utf8_too_large_1000),                                  \
+		char(utf8_carry | utf8_too_large | utf8_too_large_1000), char(utf8_carry | utf8_too_large | utf8_too_large_1000),                                  \
+		char(utf8_carry | utf8_too_large | utf8_too_large_1000), char(utf8_carry | utf8_too_large | utf8_too_large_1000),                                  \
+		char(utf8_carry | utf8_too_large | utf8_too_large_1000), char(utf8_carry | utf8_too_large | utf8_too_large_1000 | utf8_surrogate),                 \
+		char(utf8_carry | utf8_too_large | utf8_too_large_1000), char(utf8_carry | utf8_too_large | utf8_too_large_1000)
+#define KT_UTF8_BYTE_2_HIGH                                                                                                                                \
+	char(utf8_too_short), char(utf8_too_short), char(utf8_too_short), char(utf8_too_short), char(utf8_too_short), char(utf8_too_short),                    \
+		char(utf8_too_short), char(utf8_too_short),                                                                                                        \
+		char(utf8_too_long | utf8_overlong_2 | utf8_two_conts | utf8_overlong_3 | utf8_too_large_1000 | utf8_overlong_4),                                  \
+		char(utf8_too_long | utf8_overlong_2 | utf8_two_conts | utf8_overlong_3 | utf8_too_large),                                                         \
+		char(utf8_too_long | utf8_overlong_2 | utf8_two_conts | utf8_surrogate | utf8_too_large),                                                          \
+		char(utf8_too_long | utf8_overlong_2 | utf8_two_conts | utf8_surrogate | utf8_too_large), char(utf8_too_short), char(utf8_too_short),              \
+		char(utf8_too_short), char(utf8_too_short)
+
+__attribute__((target("ssse3"))) inline std::size_t utf8_validate_ssse3(std::uint8_t const* ptr, std::size_t size) noexcept {
+	auto const byte_1_high = _mm_setr_epi8(KT_UTF8_BYTE_1_HIGH);
+	auto const byte_1_low = _mm_setr_epi8(KT_UTF8_BYTE_1_LOW);
+	auto const byte_2_high = _mm_setr_epi8(KT_UTF8_BYTE_2_HIGH);
+	auto const nibble = _mm_set1_epi8(0x0F);
+	auto const max_value = _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, char(0xF0 - 1), char(0xE0 - 1), char(0xC0 - 1));
+	__m128i prev_input = _mm_setzero_si128();
+	__m128i prev_incomplete = _mm_setzero_si128();
+	std::size_t i{};
+	for (; i + 16 <= size; i += 16) {
+		auto const input = _mm_loadu_si128(reinterpret_cast<__m128i const*>(ptr + i));
+		__m128i error;
+		if (_mm_movemask_epi8(input) == 0) {
+			error = prev_incomplete;
+		} else {
+			auto const prev1 = _mm_alignr_epi8(input, prev_input, 15);
+			auto const b1h = _mm_shuffle_epi8(byte_1_high, _mm_and_si128(_mm_srli_epi16(prev1, 4), nibble));
+			auto const b1l = _mm_shuffle_epi8(byte_1_low, _mm_and_si128(prev1, nibble));
+			auto const b2h = _mm_shuffle_epi8(byte_2_high, _mm_and_si128(_mm_srli_epi16(input, 4), nibble));
+			auto const special = _mm_and_si128(_mm_and_si128(b1h, b1l), b2h);
+			auto const prev2 = _mm_alignr_epi8(input, prev_input, 14);
+			auto const prev3 = _mm_alignr_epi8(input, prev_input, 13);
+			auto const must23 = _mm_or_si128(_mm_subs_epu8(prev2, _mm_set1_epi8(char(0xE0 - 0x80))), _mm_subs_epu8(prev3, _mm_set1_epi8(char(0xF0 - 0x80))));
+			error = _mm_xor_si128(_mm_and_si128(must23, _mm_set1_epi8(char(0x80))), special);
+			prev_incomplete = _mm_subs_epu8(input, max_value);
+		}
+		if (_mm_movemask_epi8(_mm_cmpeq_epi8(error, _mm_setzero_si128())) != 0xFFFF) { return i; }
+		prev_input = input;
+	}
+	return i;
+}
+
+__attribute__((target("avx2"))) inline std::size_t utf8_validate_avx2(std::uint8_t const* ptr, std::size_t size) noexcept {
+	auto const byte_1_high = _mm256_setr_epi8(KT_UTF8_BYTE_1_HIGH, KT_UTF8_BYTE_1_HIGH);
+	auto const byte_1_low = _mm256_setr_epi8(KT_UTF8_BYTE_1_LOW, KT_UTF8_BYTE_1_LOW);
+	auto const byte_2_high = _mm256_setr_epi8(KT_UTF8_BYTE_2_HIGH, KT_UTF8_BYTE_2_HIGH);
+	auto const nibble = _mm256_set1_epi8(0x0F);
+	auto const max_value = _mm256_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+											 char(0xF0 - 1), char(0xE0 - 1), char(0xC0 - 1));
+	__m256i prev_input = _mm256_setzero_si256();
+	__m256i prev_incomplete = _mm256_setzero_si256();
+	std::size_t i{};
+	for (; i + 32 <= size; i += 32) {
+		auto const input = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(ptr + i));
+		__m256i error;
+		if (_mm256_movemask_epi8(input) == 0) {
+			error = prev_incomplete;
+		} else {
+			auto const shifted = _mm256_permute2x128_si256(prev_input, input, 0x21);
+			auto const prev1 = _mm256_alignr_epi8(input, shifted, 15);
+			auto const b1h = _mm256_shuffle_epi8(byte_1_high, _mm256_and_si256(_mm256_srli_epi16(prev1, 4), nibble));
+			auto const b1l = _mm256_shuffle_epi8(byte_1_low, _mm256_and_si256(prev1, nibble));
+			auto const b2h = _mm256_shuffle_epi8(byte_2_high, _mm256_and_si256(_mm256_srli_epi16(input, 4), nibble));
+			auto const special = _mm256_and_si256(_mm256_and_si256(b1h, b1l), b2h);
+			auto const prev2 = _mm256_alignr_epi8(input, shifted, 14);
+			auto const prev3 = _mm256_alignr_epi8(input, shifted, 13);
+			auto const must23 =
+				_mm256_or_si256(_mm256_subs_epu8(prev2, _mm256_set1_epi8(char(0xE0 - 0x80))), _mm256_subs_epu8(prev3, _mm256_set1_epi8(char(0xF0 - 0x80))));
+			error = _mm256_xor_si256(_mm256_and_si256(must23, _mm256_set1_epi8(char(0x80))), special);
+			prev_incomplete = _mm256_subs_epu8(input, max_value);
+		}
+		if (!_mm256_testz_si256(error, error)) { return i; }
+		prev_input = input;
+	}
+	return i;
+}
+
+#undef KT_UTF8_BYTE_1_HIGH
+#undef KT_UTF8_BYTE_1_LOW
+#undef KT_UTF8_BYTE_2_HIGH
+
+using utf8_block_fn = std::size_t (*)(std::uint8_t const*, std::size_t) noexcept;
+
+inline utf8_block_fn utf8_select_block_fn() noexcept {
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx2")) { return &utf8_validate_avx2; }
+	if (__builtin_cpu_supports("ssse3")) { return &utf8_validate_ssse3; }
+	return nullptr;
+}
+#endif
+} // namespace detail
+
+inline kt::result<std::size_t, utf8_error> utf8::validate(std::string_view in) {
+	auto const* ptr = reinterpret_cast<std::uint8_t const*>(in.data());
+	std::size_t start{};
+#if defined(KT_UTF8_X86_DISPATCH)
+	static detail::utf8_block_fn const block_fn = detail::utf8_select_block_fn();
+	if (block_fn) {
+		auto const verified = block_fn(ptr, in.size());
+		// resume at the lead byte of any sequence straddling the verified prefix
+		start = verified >= 3 ? verified - 3 : 0;
+		while (start < verified && (ptr[start] & 0xC0) == 0x80) { ++start; }
+	}
+#endif
+	return detail::utf8_validate_scalar(ptr, in.size(), start);
+}
+
+inline kt::result<std::size_t, utf8_error> utf8::to_utf16(std::string_view in, char16_t* out, std::size_t capacity) {
+	auto const* ptr = reinterpret_cast<std::uint8_t const*>(in.data());
+	std::size_t written{};
+	std::size_t i{};
+	while (i < in.size()) {
+		auto const ascii = detail::utf8_ascii_prefix(ptr + i, in.size() - i);
+		if (written + ascii > capacity) { return utf8_error{i, utf8_error::kind::output_too_small}; }
+		for (std::size_t j = 0; j < ascii; ++j) { out[written++] = ptr[i + j]; }
+		i += ascii;
+		if (i == in.size()) { break; }
+		char32_t cp;
+		auto const len = detail::utf8_decode(ptr, in.size(), i, cp);
+		if (!len) { return len.error(); }
+		std::size_t const units = cp >= 0x10000 ? 2 : 1;
+		if (written + units > capacity) { return utf8_error{i, utf8_error::kind::output_too_small}; }
+		if (units == 2) {
+			cp -= 0x10000;
+			out[written++] = char16_t(0xD800 + (cp >> 10));
+			out[written++] = char16_t(0xDC00 + (cp & 0x3FF));
+		} else {
+			out[written++] = char16_t(cp);
+		}
+		i += len.value();
+	}
+	return written;
+}
+
+inline kt::result<std::size_t, utf8_error> utf8::to_utf32(std::string_view in, char32_t* out, std::size_t capacity) {
+	auto const* ptr = reinterpret_cast<std::uint8_t const*>(in.data());
+	std::size_t written{};
+	std::size_t i{};
+	while (i < in.size()) {
+		auto const ascii = detail::utf8_ascii_prefix(ptr + i, in.size() - i);
+		if (written + ascii > capacity) { return utf8_error{i, utf8_error::kind::output_too_small}; }
+		for (std::size_t j = 0; j < ascii; ++j) { out[written++] = ptr[i + j]; }
+		i += ascii;
+		if (i == in.size()) { break; }
+		if (written == capacity) { return utf8_error{i, utf8_error::kind::output_too_small}; }
+		auto const len = detail::utf8_decode(ptr, in.size(), i, out[written]);
+		if (!len) { return len.error(); }
+		++written;
+		i += len.value();
+	}
+	return written;
+}
+
+namespace detail {
+inline std::size_t utf8_encode(char32_t cp, char* out) noexcept {
+	if (cp < 0x80) {
+		out[0] = char(cp);
+		return 1;
+	}
+	if (cp < 0x800) {
+		out[0] = char(0xC0 | (cp >> 6));
+		out[1] = char(0x80 | (cp & 0x3F));
+		return 2;
+	}
+	if (cp < 0x10000) {
+		out[0] = char(0xE0 | (cp >> 12));
+		out[1] = char(0x80 | ((cp >> 6) & 0x3F));
+		out[2] = char(0x80 | (cp & 0x3F));
+		return 3;
+	}
+	out[0] = char(0xF0 | (cp >> 18));
+	out[1] = char(0x80 | ((cp >> 12) & 0x3F));
+	out[2] = char(0x80 | ((cp >> 6) & 0x3F));
+	out[3] = char(0x80 | (cp & 0x3F));
+	return 4;
+}
+
+constexpr std::size_t utf8_encoded_length(char32_t cp) noexcept { return cp < 0x80 ? 1 : cp < 0x800 ? 2 : cp < 0x10000 ? 3 : 4; }
+} // namespace detail
+
+inline kt::result<std::size_t, utf8_error> utf8::from_utf16(std::u16string_view in, char* out, std::size_t capacity) {
+	std::size_t written{};
+	for (std::size_t i = 0; i < in.size(); ++i) {
+		char32_t cp = in[i];
+		std::size_t const start = i;
+		if (cp >= 0xD800 && cp < 0xE000) {
+			if (cp >= 0xDC00 || i + 1 == in.size() || in[i + 1] < 0xDC00 || in[i + 1] >= 0xE000) { return utf8_error{start, utf8_error::kind::surrogate}; }
+			cp = 0x10000 + ((cp - 0xD800) << 10) + (in[++i] - 0xDC00);
+		}
+		if (written + detail::utf8_encoded_length(cp) > capacity) { return utf8_error{start, utf8_error::kind::output_too_small}; }
+		written += detail::utf8_encode(cp, out + written);
+	}
+	return written;
+}
+
+inline kt::result<std::size_t, utf8_error> utf8::from_utf32(std::u32string_view in, char* out, std::size_t capacity) {
+	std::size_t written{};
+	for (std::size_t i = 0; i < in.size(); ++i) {
+		char32_t const cp = in[i];
+		if (cp >= 0xD800 && cp < 0xE000) { return utf8_error{i, utf8_error::kind::surrogate}; }
+		if (cp > 0x10FFFF) { return utf8_error{i, utf8_error::kind::too_large}; }
+		if (written + detail::utf8_encoded_length(cp) > capacity) { return utf8_error{i, utf8_error::kind::output_too_small}; }
+		written += detail::utf8_encode(cp, out + written);
+	}
+	return written;
+}
+} // namespace kt
@@ -0,0 +1,181 @@
+// KT header-only library
+// Requirements: C++17
+
+#pragma once
+#include "result.hpp"
+#include <cstdint>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define KT_VARINT_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace kt {
+///
+/// \brief Malformed varint: offset of its first byte and kind
+/// 	- truncated : input ended before the terminating byte
+/// 	- overlong : more than 10 bytes, or a non-minimal encoding (final byte of a multi-byte varint is zero)
+/// 	- overflow : 10th byte carries bits beyond 64
+///
+struct varint_error {
+	enum class kind { unknown, truncated, overlong, overflow, output_too_small };
+
+	std::size_t offset{};
+	kind type{};
+};
+
+namespace varint {
+constexpr std::size_t max_length = 10;
+
+constexpr std::uint64_t zigzag_encode(std::int64_t value) noexcept { return (static_cast<std::uint64_t>(value) << 1) ^ static_cast<std::uint64_t>(value >> 63); }
+constexpr std::int64_t zigzag_decode(std::uint64_t value) noexcept { return static_cast<std::int64_t>(value >> 1) ^ -static_cast<std::int64_t>(value & 1); }
+
+///
+/// \brief Encode value into out (which must hold max_length bytes); returns bytes written
+///
+std::size_t encode(std::uint64_t value, std::uint8_t* out) noexcept;
+
+///
+/// \brief Decode one unsigned varint; sets length to bytes consumed on success
+///
+kt::result<std::uint64_t, varint_error> decode(std::uint8_t const* in, std::size_t size, std::size_t& length) noexcept;
+///
+/// \brief Decode one zigzag-encoded signed varint
+///
+kt::result<std::int64_t, varint_error> decode_zigzag(std::uint8_t const* in, std::size_t size, std::size_t& length) noexcept;
+
+///
+/// \brief Decode all varints in [in, in + size) into out; returns count decoded
+/// Blocks of 16 single-byte varints are widened directly; others are decoded 8 bytes at a time without per-byte branches
+///
+kt::result<std::size_t, varint_error> decode_all(std::uint8_t const* in, std::size_t size, std::uint64_t* out, std::size_t capacity) noexcept;
+kt::result<std::size_t, varint_error> decode_all_zigzag(std::uint8_t const* in, std::size_t size, std::int64_t* out, std::size_t capacity) noexcept;
+} // namespace varint
+
+namespace detail {
+inline int varint_ctz(std::uint64_t x) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+	return __builtin_ctzll(x);
+#else
+	int ret{};
+	while ((x & 1) == 0) {
+		x >>= 1;
+		++ret;
+	}
+	return ret;
+#endif
+}
+
+inline std::uint64_t varint_load(std::uint8_t const* in, std::size_t size) noexcept {
+	std::uint64_t ret{};
+	if (size >= 8) {
+		std::memcpy(&ret, in, 8);
+	} else {
+		std::memcpy(&ret, in, size);
+	}
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+	ret = __builtin_bswap64(ret);
+#endif
+	return ret;
+}
+
+///
+/// \brief Pack the low 7 bits of each byte in word (little endian) into a 56-bit value
+///
+constexpr std::uint64_t varint_compact(std::uint64_t word) noexcept {
+	word &= 0x7F7F7F7F7F7F7F7FULL;
+	word = (word & 0x007F007F007F007FULL) | ((word & 0x7F007F007F007F00ULL) >> 1);
+	word = (word & 0x00003FFF00003FFFULL) | ((word & 0x3FFF00003FFF0000ULL) >> 2);
+	return (word & 0x000000000FFFFFFFULL) | ((word & 0x0FFFFFFF00000000ULL) >> 4);
+}
+
+inline kt::result<std::uint64_t, varint_error> varint_decode(std::uint8_t const* in, std::size_t size, std::size_t offset, std::size_t& length) noexcept {
+	using kind = varint_error::kind;
+	std::uint64_t const word = varint_load(in, size);
+	// terminators: bytes with the high bit clear (bytes past the end load as zero and must not count)
+	std::uint64_t const valid = size >= 8 ? ~std::uint64_t(0) : (std::uint64_t(1) << (size * 8)) - 1;
+	std::uint64_t const stops = ~word & 0x8080808080808080ULL & valid;
+	if (stops) {
+		auto const bits = static_cast<unsigned>(varint_ctz(stops)) + 1;
+		// a zero terminator after continuation bytes adds no bits: the encoding is not minimal
+		if (bits > 8 && ((word >> (bits - 8)) & 0x7F) == 0) { return varint_error{offset, kind::overlong}; }
+		length = bits / 8;
+		std::uint64_t const mask = bits == 64 ? ~std::uint64_t(0) : (std::uint64_t(1) << bits) - 1;
+		return varint_compact(word & mask);
+	}
+	if (size < 9) { return varint_error{offset, kind::truncated}; }
+	std::uint64_t const low = varint_compact(word);
+	std::uint8_t const b8 = in[8];
+	if (b8 < 0x80) {
+		if (b8 == 0) { return varint_error{offset, kind::overlong}; }
+		length = 9;
+		return low | (std::uint64_t(b8) << 56);
+	}
+	if (size < 10) { return varint_error{offset, kind::truncated}; }
+	std::uint8_t const b9 = in[9];
+	if (b9 >= 0x80) { return varint_error{offset, kind::overlong}; }
+	if (b9 > 1) { return varint_error{offset, kind::overflow}; }
+	if (b9 == 0) { return varint_error{offset, kind::overlong}; }
+	length = 10;
+	return low | (std::uint64_t(b8 & 0x7F) << 56) | (std::uint64_t(b9) << 63);
+}
+
+template <typename T, typename F>
+kt::result<std::size_t, varint_error> varint_decode_all(std::uint8_t const* in, std::size_t size, T* out, std::size_t capacity, F convert) noexcept {
+	std::size_t i{};
+	std::size_t count{};
+	while (i < size) {
+#if defined(KT_VARINT_SSE2)
+		if (size - i >= 16 && capacity - count >= 16) {
+			auto const block = _mm_loadu_si128(reinterpret_cast<__m128i const*>(in + i));
+			if (_mm_movemask_epi8(block) == 0) {
+				alignas(16) std::uint8_t bytes[16];
+				_mm_store_si128(reinterpret_cast<__m128i*>(bytes), block);
+				for (int j = 0; j < 16; ++j) { out[count + std::size_t(j)] = convert(bytes[j]); }
+				count += 16;
+				i += 16;
+				continue;
+			}
+		}
+#endif
+		if (count == capacity) { return varint_error{i, varint_error::kind::output_too_small}; }
+		std::size_t length{};
+		auto const value = varint_decode(in + i, size - i, i, length);
+		if (!value) { return value.error(); }
+		out[count++] = convert(value.value());
+		i += length;
+	}
+	return count;
+}
+} // namespace detail
+
+inline std::size_t varint::encode(std::uint64_t value, std::uint8_t* out) noexcept {
+	std::size_t ret{};
+	while (value >= 0x80) {
+		out[ret++] = static_cast<std::uint8_t>(value | 0x80);
+		value >>= 7;
+	}
+	out[ret++] = static_cast<std::uint8_t>(value);
+	return ret;
+}
+
+inline kt::result<std::uint64_t, varint_error> varint::decode(std::uint8_t const* in, std::size_t size, std::size_t& length) noexcept {
+	if (size == 0) { return varint_error{0, varint_error::kind::truncated}; }
+	return detail::varint_decode(in, size, 0, length);
+}
+
+inline kt::result<std::int64_t, varint_error> varint::decode_zigzag(std::uint8_t const* in, std::size_t size, std::size_t& length) noexcept {
+	auto const ret = decode(in, size, length);
+	if (!ret) { return ret.error(); }
+	return zigzag_decode(ret.value());
+}
+
+inline kt::result<std::size_t, varint_error> varint::decode_all(std::uint8_t const* in, std::size_t size, std::uint64_t* out, std::size_t capacity) noexcept {
+	return detail::varint_decode_all(in, size, out, capacity, [](std::uint64_t v) { return v; });
+}
+
+inline kt::result<std::size_t, varint_error> varint::decode_all_zigzag(std::uint8_t const* in, std::size_t size, std::int64_t* out, std::size_t capacity) noexcept {
+	return detail::varint_decode_all(in, size, out, capacity, [](std::uint64_t v) { return zigzag_decode(v); });
+}
+} // namespace kt